@@ -25,6 +25,21 @@
 #define COMMAND			0
 
 //*********************************Variables***********************************
+//output of the formatting engine
+typedef void (*tOledOutput)(const char *pcBuf, uint8_t ui8Len, void *pvCtx);
+typedef struct
+{
+	char *pcBuf;
+	uint8_t ui8Size;
+	uint8_t ui8Pos;
+} OLED_BUFFER_OUTPUT;
+
+// Flags of a conversion (Oled_vformat)
+#define FORMAT_LEFT		0x01	// '-': left-justify
+#define FORMAT_PLUS		0x02	// '+': '+' before positive values
+#define FORMAT_SPACE	0x04	// ' ': space before positive values
+#define FORMAT_ZERO		0x08	// '0': pad with zeros
+
 #ifndef USE_MULTI_PAGE
 static uint8_t Oled_buff[OLED_COLUMNSIZE][OLED_PAGESIZE];
 #else
@@ -34,6 +49,17 @@ static uint8_t page_index = 0;
 #endif
 
 static const char * const g_pcHex = "0123456789abcdef";
+static const char * const g_pcHexUpper = "0123456789ABCDEF";
+static const uint32_t g_pui32Pow10[10] = {
+		1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+//bit spreading tables for scaled drawing: every bit of a nibble is repeated
+//2 times (byte) or 3 times (12 bits)
+static const uint8_t g_pui8Spread2[16] = {
+		0x00, 0x03, 0x0C, 0x0F, 0x30, 0x33, 0x3C, 0x3F,
+		0xC0, 0xC3, 0xCC, 0xCF, 0xF0, 0xF3, 0xFC, 0xFF};
+static const uint16_t g_pui16Spread3[16] = {
+		0x000, 0x007, 0x038, 0x03F, 0x1C0, 0x1C7, 0x1F8, 0x1FF,
+		0xE00, 0xE07, 0xE38, 0xE3F, 0xFC0, 0xFC7, 0xFF8, 0xFFF};
 // ASCII table
 const uint8_t ASCII[] ={
 		0x00, 0x00, 0x00, 0x00, 0x00, // 20
@@ -231,15 +257,50 @@ const FONT_CHAR_INFO ASCIIDescriptors[] = {
 	{5, 470}, 		/* -> */
 	{5, 475}			/* <- */
 };
-const FONT_INFO fi_default = {8, ' ', 0x7F, ASCIIDescriptors, ASCII};
+const FONT_INFO fi_default = {8, ' ', 0x7F, ASCIIDescriptors, ASCII, FONT_FORMAT_RAW, 0, 0, 0, 0};
 static FONT_INFO *CurrentFont = &fi_default;	//default: ASCII 5x8
 static uint8_t currentX = 0, currentY = 0;	//for print text
+static uint8_t textScale = 1;				//text scale factor (1 to 4)
+//8x8 pattern of the filled shapes (column bytes)
+static uint8_t fillPattern[8] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+//last range found in a sparse font
+static const FONT_INFO *rangeFont = 0;
+static uint8_t rangeIndex = 0;
+//dirty area of the screen buffer (empty when x0 >= x1)
+static uint8_t dirtyX0 = OLED_COLUMNSIZE, dirtyY0 = OLED_HEIGHT;
+static uint8_t dirtyX1 = 0, dirtyY1 = 0;
 
 //*************************Private function prototypes*************************
-static void Oled_Putchar(char c);
+static void Oled_Putchar(uint16_t code);
+static int16_t Oled_find_glyph(const FONT_INFO *font, uint16_t code);
+static uint8_t Oled_glyph_data(const FONT_INFO *font, int16_t index, const uint8_t **data);
+static uint16_t Oled_utf8_next(const uint8_t **ppui8Str, const uint8_t *pui8End);
 static void Oled_Putstring(const char *pcBuf, uint8_t ui8Len);
+static void Oled_vformat(tOledOutput pfnOut, void *pvCtx,
+						 const char *pcString, va_list vaArgP);
+static char *Oled_format_dec(uint32_t ui32Value, char *pcEnd);
+static char *Oled_format_hex(uint32_t ui32Value, char *pcEnd, const char *pcDigits);
+static char *Oled_format_float(double dValue, int16_t i16Prec, char *pcEnd, char *pcSign);
+static void Oled_format_pad(tOledOutput pfnOut, void *pvCtx, char cFill, uint16_t ui16Count);
+static void Oled_print_output(const char *pcBuf, uint8_t ui8Len, void *pvCtx);
+static void Oled_measure_output(const char *pcBuf, uint8_t ui8Len, void *pvCtx);
+static void Oled_buffer_output(const char *pcBuf, uint8_t ui8Len, void *pvCtx);
+static void Oled_set_rect(OLED_RECT *pRect, uint8_t x, uint8_t y, uint16_t w, uint8_t h);
+static uint8_t Oled_row_mask(int8_t page, uint8_t y, uint8_t h);
+static void Oled_draw_glyph(uint8_t x, uint8_t y, uint8_t w, uint8_t h,
+							const uint8_t *glyph, uint8_t stride, uint8_t top);
+static void Oled_draw_rle_glyph(uint8_t x, uint8_t y, uint8_t w, uint8_t h,
+								const uint8_t *rle, uint8_t top);
+static uint32_t Oled_spread(uint8_t value, uint8_t scale);
+static void Oled_draw_spread(uint8_t x, int16_t y, uint8_t start, int16_t end,
+							 uint32_t bits, uint8_t scale);
+static void Oled_draw_scaled_glyph(uint8_t x, uint8_t y, uint8_t w, uint8_t h,
+								   const uint8_t *glyph, bool rle, uint8_t top);
 static void Oled_Draw8PixelV(uint8_t x, uint8_t y, uint8_t pixel, uint8_t n_pixel);
 static void Oled_Draw8PixelH(uint8_t x, uint8_t y, uint8_t pixel, uint8_t n_pixel);
+static uint8_t Oled_run_top(const uint8_t *col, uint8_t y);
+static uint8_t Oled_run_bottom(const uint8_t *col, uint8_t y);
+static int16_t Oled_next_clear(const uint8_t *col, uint8_t y, uint8_t bottom);
 // static void Oled_UpdateScreen(void);
 /* TODO: put Update screen to private scope */
 
@@ -440,8 +501,76 @@ void Oled_SetFont(FONT_INFO *font)
 }
 
 /******************************************************************************
- * A simple Oled based printf function supporting \%c, \%d, \%p, \%s, \%u,
- * \%x, and \%X.
+ * Oled_GetFont - Get the font used for printing text
+ *
+ * Parameter: none
+ *
+ * Return: pointer to the current font information
+ *****************************************************************************/
+FONT_INFO *Oled_GetFont(void)
+{
+	return CurrentFont;
+}
+
+/******************************************************************************
+ * Oled_SetTextScale - Set the scale factor of printed text
+ * Every pixel of the font is drawn as a scale x scale square, so a 5x8 font
+ * gives 10x16 text at scale 2. The text measuring functions (Oled_CharWidth,
+ * Oled_FontHeight, Oled_TextWidth...) use the scaled size.
+ *
+ * Parameter:
+ * 	scale: 1 (default) to 4, out of range values are clamped
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_SetTextScale(uint8_t scale)
+{
+	textScale = !scale ? 1 : (scale > 4) ? 4 : scale;
+}
+
+/******************************************************************************
+ * Oled_DrawChar - draw a single character of the current font
+ *
+ * Parameter:
+ * 	(x, y): upper left position of the character
+ * 	code  : the character (Unicode code point)
+ *
+ * Return: number of columns used by the character (same as Oled_CharWidth)
+ *****************************************************************************/
+uint8_t Oled_DrawChar(uint8_t x, uint8_t y, uint16_t code)
+{
+	currentX = x;
+	currentY = y;
+	Oled_Putchar(code);
+	return currentX - x;
+}
+
+/******************************************************************************
+ * Oled_NextChar - decode the next character of an UTF-8 string
+ * Code points above 0xFFFF and invalid sequences are returned as 0xFFFD
+ * (which is usually not in the font and so not drawn).
+ *
+ * Parameter:
+ * 	ppcString: pointer to the string pointer, moved to the next character
+ *
+ * Return: the character (Unicode code point), 0 at the end of the string
+ *****************************************************************************/
+uint16_t Oled_NextChar(const char **ppcString)
+{
+	const uint8_t *str = (const uint8_t *)*ppcString;
+	uint16_t code;
+
+	if (!*str)
+		return 0;
+	//an UTF-8 sequence has maximum 4 bytes, a '\0' stops it before
+	code = Oled_utf8_next(&str, str + 4);
+	*ppcString = (const char *)str;
+	return code;
+}
+
+/******************************************************************************
+ * A simple Oled based printf function supporting \%c, \%d, \%f, \%p, \%s,
+ * \%u, \%x, and \%X.
  *
  * Parameter:
  * 	pcString is the format string.
@@ -454,21 +583,36 @@ void Oled_SetFont(FONT_INFO *font)
  *
  * - \%c to print a character
  * - \%d or \%i to print a decimal value
+ * - \%f to print a floating point value in fixed-point notation
  * - \%s to print a string
  * - \%u to print an unsigned decimal value
  * - \%x to print a hexadecimal value using lower case letters
- * - \%X to print a hexadecimal value using lower case letters (not upper case
- * letters as would typically be used)
+ * - \%X to print a hexadecimal value using upper case letters
  * - \%p to print a pointer as a hexadecimal value
  * - \%\% to print out a \% character
  *
- * For \%s, \%d, \%i, \%u, \%p, \%x, and \%X, an optional number may reside
- * between the \% and the format character, which specifies the minimum number
- * of characters to use for that value; if preceded by a 0 then the extra
- * characters will be filled with zeros instead of spaces.  For example,
+ * A conversion is written \%[flags][width][.precision]type:
+ * - flags: ``-'' left-justifies the value in its width, ``0'' pads numbers
+ * with zeros instead of spaces, ``+'' (or a space) is written before positive
+ * \%d, \%i and \%f values
+ * - width: minimum number of characters to use for the value. For example,
  * ``\%8d'' will use eight characters to print the decimal value with spaces
  * added to reach eight; ``\%08d'' will use eight characters as well but will
- * add zeroes instead of spaces.
+ * add zeroes instead of spaces
+ * - precision: digits after the decimal point for \%f (0 to 9, default 6),
+ * maximum number of characters for \%s
+ * Width and precision can be ``*'' to take them from the arguments. The l and
+ * h length modifiers are accepted and ignored.
+ *
+ * \%f handles values up to 4294967295 (larger values are printed as ``inf'')
+ * and rounds the last digit half away from zero.
+ *
+ * Breaking changes of revision 2.02:
+ * - a width right-justifies strings like numbers: ``\%8s'' now adds the
+ * spaces before the string, older code added them after it. Use ``\%-8s''
+ * to keep the former layout
+ * - integer values are read as int (unsigned int for \%u, \%x and \%X), not
+ * unsigned long
  *
  * The type of the arguments after \e pcString must match the requirements of
  * the format string.  For example, if an integer was passed where a string
@@ -478,221 +622,561 @@ void Oled_SetFont(FONT_INFO *font)
  *****************************************************************************/
 void Oled_printf(uint8_t x, uint8_t y, const char *pcString, ...)
 {
-	static unsigned int ulPos, ulCount, ulNeg;
-	unsigned long ulValue, ulBase, ulIdx;
-	char *pcStr, pcBuf[16], cFill;
 	va_list vaArgP;
 
 	currentX = x;
 	currentY = y;
 	va_start(vaArgP, pcString);		// Start the varargs processing.
+	Oled_vformat(Oled_print_output, 0, pcString, vaArgP);
+	va_end(vaArgP);	// End the varargs processing.
+}
 
-	// Loop while there are more characters in the string.
-	while(*pcString)
-	{
-		for(ulIdx = 0; (pcString[ulIdx] != '%') && (pcString[ulIdx] != '\0');
-				ulIdx++);		// Find the first non-% character, or the end of the string.
+/******************************************************************************
+ * Oled_snprintf - format a string into a buffer without drawing
+ * The format characters are the same as in Oled_printf. The output is
+ * truncated to fit the buffer and always terminated by '\0'.
+ *
+ * Parameter:
+ * 	pcBuf	: output buffer
+ * 	ui8Size : size of the output buffer (including the terminating '\0')
+ * 	pcString: format string
+ * 	...		: arguments of the format string
+ *
+ * Return: number of characters written (not including the '\0')
+ *****************************************************************************/
+uint8_t Oled_snprintf(char *pcBuf, uint8_t ui8Size, const char *pcString, ...)
+{
+	va_list vaArgP;
+	uint8_t len;
+
+	va_start(vaArgP, pcString);
+	len = Oled_vsnprintf(pcBuf, ui8Size, pcString, vaArgP);
+	va_end(vaArgP);
+	return len;
+}
+
+/******************************************************************************
+ * Oled_vsnprintf - same as Oled_snprintf but take a va_list argument
+ *****************************************************************************/
+uint8_t Oled_vsnprintf(char *pcBuf, uint8_t ui8Size, const char *pcString,
+					   va_list vaArgP)
+{
+	OLED_BUFFER_OUTPUT out;
 
-		Oled_Putstring(pcString, ulIdx);		// Write this portion of the string.
+	if (!ui8Size)
+		return 0;
 
-		pcString += ulIdx;		// Skip the portion of the string that was written.
+	out.pcBuf = pcBuf;
+	out.ui8Size = ui8Size - 1;	//keep room for the '\0'
+	out.ui8Pos = 0;
+	Oled_vformat(Oled_buffer_output, &out, pcString, vaArgP);
+	pcBuf[out.ui8Pos] = '\0';
+	return out.ui8Pos;
+}
 
-		if(*pcString == '%')		// See if the next character is a %.
-		{
-			pcString++;			// Skip the %.
+/******************************************************************************
+ * Oled_CharWidth - get the advance width of a character in the current font
+ *
+ * Parameter:
+ * 	code: a character (Unicode code point)
+ *
+ * Return: number of columns used by the character, including the 1-pixel-wide
+ * space before it (0 if the character is not in the font)
+ *****************************************************************************/
+uint8_t Oled_CharWidth(uint16_t code)
+{
+	int16_t index = Oled_find_glyph(CurrentFont, code);
 
-			// Set the digit count to zero, and the fill character to space
-			// (i.e. to the defaults).
-			ulCount = 0;
-			cFill = ' ';
+	return (index < 0) ? 0 : (1 + Oled_glyph_data(CurrentFont, index, 0)) * textScale;
+}
 
-			// It may be necessary to get back here to process more characters.
-			// Goto's aren't pretty, but effective.  I feel extremely dirty for
-			// using not one but two of the beasts.
-			again:
+/******************************************************************************
+ * Oled_FontHeight - get the height of the current font
+ *
+ * Parameter: none
+ *
+ * Return: height of a text line in pixel
+ *****************************************************************************/
+uint8_t Oled_FontHeight(void)
+{
+	return CurrentFont->heightPages * textScale;
+}
 
-			// Determine how to handle the next character.
-			switch(*pcString++)
-			{
-			// Handle the digit characters.
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7':
-			case '8':
-			case '9':
-			{
-				// If this is a zero, and it is the first digit, then the
-				// fill character is a zero instead of a space.
-				if((pcString[-1] == '0') && (ulCount == 0))
-					cFill = '0';
+/******************************************************************************
+ * Oled_TextWidth - measure a string in the current font
+ * Nothing is drawn, the result is the same as the number of columns
+ * Oled_printf would use for the string.
+ *
+ * Parameter:
+ * 	pcString: input UTF-8 string (not a format string)
+ *
+ * Return: width of the string in pixel
+ *****************************************************************************/
+uint16_t Oled_TextWidth(const char *pcString)
+{
+	uint16_t width = 0;
 
-				// Update the digit count.
-				ulCount *= 10;
-				ulCount += pcString[-1] - '0';
+	while (*pcString)
+		width += Oled_CharWidth(Oled_NextChar(&pcString));
+	return width;
+}
 
-				// Get the next character.
-				goto again;
-			}
+/******************************************************************************
+ * Oled_TextWidthf - measure the output of a format string in the current font
+ * The format characters are the same as in Oled_printf. Nothing is drawn.
+ *
+ * Parameter:
+ * 	pcString: format string
+ * 	...		: arguments of the format string
+ *
+ * Return: width of the formatted text in pixel
+ *****************************************************************************/
+uint16_t Oled_TextWidthf(const char *pcString, ...)
+{
+	va_list vaArgP;
+	uint16_t width = 0;
 
-			// Handle the %c command.
-			case 'c':
-			{
-				ulValue = va_arg(vaArgP, unsigned long);	// Get the value from the varargs.
-				Oled_Putstring((char *)&ulValue, 1);		// Print out the character.
+	va_start(vaArgP, pcString);
+	Oled_vformat(Oled_measure_output, &width, pcString, vaArgP);
+	va_end(vaArgP);
+	return width;
+}
 
-				// This command has been handled.
-				break;
-			}
+/******************************************************************************
+ * Oled_TextBounds - get the area covered by a string printed at (x, y)
+ * The area is clipped to the screen, so it can be passed directly to
+ * Oled_UpdateScreen or Oled_Clear.
+ *
+ * Parameter:
+ * 	(x, y)	: upper left position of the text
+ * 	pcString: input string (not a format string)
+ * 	pRect	: returned area
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_TextBounds(uint8_t x, uint8_t y, const char *pcString, OLED_RECT *pRect)
+{
+	Oled_set_rect(pRect, x, y, Oled_TextWidth(pcString), Oled_FontHeight());
+}
 
-			// Handle the %d and %i commands.
-			case 'd':
-			case 'i':
-			{
-				ulValue = va_arg(vaArgP, unsigned long);		// Get the value from the varargs.
-				ulPos = 0;		// Reset the buffer position.
+/******************************************************************************
+ * Oled_printfAligned - print a formatted text aligned inside a box
+ * The text is formatted and measured once, then drawn at its final
+ * position. Text wider than the box starts at the left edge of the box.
+ *
+ * Parameter:
+ * 	pBox	: the box to align the text in
+ * 	ui8Align: TEXT_ALIGN_LEFT, TEXT_ALIGN_CENTER or TEXT_ALIGN_RIGHT combined
+ * 	with TEXT_ALIGN_TOP, TEXT_ALIGN_MIDDLE or TEXT_ALIGN_BOTTOM
+ * 	pArea	: returned area covered by the text (can be null)
+ * 	pcString: format string, see Oled_printf
+ * 	...		: arguments of the format string
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_printfAligned(const OLED_RECT *pBox, uint8_t ui8Align, OLED_RECT *pArea,
+						const char *pcString, ...)
+{
+	char pcBuf[OLED_TEXT_BUFSIZE];
+	va_list vaArgP;
+	uint16_t width;
+	uint8_t len, height, x, y;
 
-				// If the value is negative, make it positive and indicate
-				// that a minus sign is needed.
-				if((long)ulValue < 0)
-				{
-					ulValue = -(long)ulValue;			// Make the value positive.
-					ulNeg = 1;	// Indicate that the value is negative.
-				}
-				else
-				{
-					// Indicate that the value is positive so that a minus
-					// sign isn't inserted.
-					ulNeg = 0;
-				}
+	va_start(vaArgP, pcString);
+	len = Oled_vsnprintf(pcBuf, sizeof(pcBuf), pcString, vaArgP);
+	va_end(vaArgP);
 
-				ulBase = 10;		// Set the base to 10.
+	width = Oled_TextWidth(pcBuf);
+	height = Oled_FontHeight();
 
-				// Convert the value to ASCII.
-				goto convert;
-			}
+	x = pBox->x;
+	if (width < pBox->w)
+	{
+		if (ui8Align & TEXT_ALIGN_CENTER)
+			x += (pBox->w - width) / 2;
+		else if (ui8Align & TEXT_ALIGN_RIGHT)
+			x += pBox->w - width;
+	}
+	y = pBox->y;
+	if (height < pBox->h)
+	{
+		if (ui8Align & TEXT_ALIGN_MIDDLE)
+			y += (pBox->h - height) / 2;
+		else if (ui8Align & TEXT_ALIGN_BOTTOM)
+			y += pBox->h - height;
+	}
 
-			// Handle the %s command.
-			case 's':
-			{
-				pcStr = va_arg(vaArgP, char *);		// Get the string pointer from the varargs.
+	currentX = x;
+	currentY = y;
+	Oled_Putstring(pcBuf, len);
 
-				for(ulIdx = 0; pcStr[ulIdx] != '\0'; ulIdx++);		// Determine the length of the string.
-				Oled_Putstring(pcStr, ulIdx);		// Write the string.
+	if (pArea)
+		Oled_set_rect(pArea, x, y, width, height);
+}
 
-				// Write any required padding spaces
-				if(ulCount > ulIdx)
-				{
-					ulCount -= ulIdx;
-					while(ulCount--)
-						Oled_Putstring(" ", 1);
-				}
-				// This command has been handled.
+/******************************************************************************
+ * Oled_vformat - the formatting engine of Oled_printf
+ * The format string is processed and every piece of output text is passed to
+ * an output function, which draws, measures or stores the text.
+ * Check Oled_printf for the supported format characters.
+ *
+ * Parameter:
+ * 	pfnOut	: output function
+ * 	pvCtx	: context passed to the output function
+ * 	pcString: format string
+ * 	vaArgP	: arguments of the format string
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_vformat(tOledOutput pfnOut, void *pvCtx,
+						 const char *pcString, va_list vaArgP)
+{
+	char pcBuf[24], cSign, cPositive;
+	const char *pcStr, *pcEnd;
+	uint32_t ui32Value;
+	int32_t i32Value;
+	uint16_t ui16Len, ui16Zero, ui16Pad, ui16Width;
+	int16_t i16Prec;
+	uint8_t ui8Flags;
+
+	// Loop while there are more characters in the string.
+	while(*pcString)
+	{
+		for(ui16Len = 0; (pcString[ui16Len] != '%') && (pcString[ui16Len] != '\0');
+				ui16Len++);		// Find the first non-% character, or the end of the string.
+
+		if(ui16Len)
+			pfnOut(pcString, ui16Len, pvCtx);		// Write this portion of the string.
+
+		pcString += ui16Len;		// Skip the portion of the string that was written.
+
+		if(*pcString != '%')
+			break;
+		pcString++;			// Skip the %.
+
+		// Flags
+		for(ui8Flags = 0; ; pcString++)
+		{
+			if(*pcString == '-')
+				ui8Flags |= FORMAT_LEFT;
+			else if(*pcString == '+')
+				ui8Flags |= FORMAT_PLUS;
+			else if(*pcString == ' ')
+				ui8Flags |= FORMAT_SPACE;
+			else if(*pcString == '0')
+				ui8Flags |= FORMAT_ZERO;
+			else
 				break;
+		}
+
+		// Minimum width, from the format string or from the arguments
+		ui16Width = 0;
+		if(*pcString == '*')
+		{
+			pcString++;
+			i32Value = va_arg(vaArgP, int);
+			if(i32Value < 0)
+			{
+				ui8Flags |= FORMAT_LEFT;
+				i32Value = -i32Value;
 			}
+			ui16Width = (uint16_t)i32Value;
+		}
+		for(; (*pcString >= '0') && (*pcString <= '9'); pcString++)
+			ui16Width = ui16Width * 10 + (*pcString - '0');
 
-			// Handle the %u command.
-			case 'u':
+		// Precision (-1: not given)
+		i16Prec = -1;
+		if(*pcString == '.')
+		{
+			pcString++;
+			i16Prec = 0;
+			if(*pcString == '*')
 			{
-				ulValue = va_arg(vaArgP, unsigned long);	// Get the value from the varargs.
-				ulPos = 0;			// Reset the buffer position.
-				ulBase = 10;		// Set the base to 10.
+				pcString++;
+				i16Prec = (int16_t)va_arg(vaArgP, int);
+			}
+			for(; (*pcString >= '0') && (*pcString <= '9'); pcString++)
+				i16Prec = i16Prec * 10 + (*pcString - '0');
+		}
 
-				// Indicate that the value is positive so that a minus sign
-				// isn't inserted.
-				ulNeg = 0;
+		// Length modifiers are accepted but not needed: int and long are
+		// both 32-bit, float is promoted to double
+		while((*pcString == 'l') || (*pcString == 'h'))
+			pcString++;
+		if(!*pcString)
+			break;
 
-				goto convert;		// Convert the value to ASCII.
-			}
+		// Sign of a positive signed value
+		cPositive = (ui8Flags & FORMAT_PLUS) ? '+' : (ui8Flags & FORMAT_SPACE) ? ' ' : 0;
+		cSign = 0;
 
-			// Handle the %x and %X commands.  Note that they are treated
-			// identically; i.e. %X will use lower case letters for a-f
-			// instead of the upper case letters is should use.  We also
-			// alias %p to %x.
-			case 'x':
-			case 'X':
-			case 'p':
+		// The converted value is written backward from the end of pcBuf
+		pcEnd = &pcBuf[sizeof(pcBuf)];
+
+		switch(*pcString++)
+		{
+		case 'c':
+			pcBuf[sizeof(pcBuf) - 1] = (char)va_arg(vaArgP, int);
+			pcStr = &pcBuf[sizeof(pcBuf) - 1];
+			ui8Flags &= ~FORMAT_ZERO;
+			break;
+
+		case 'd':
+		case 'i':
+			i32Value = va_arg(vaArgP, int);
+			if(i32Value < 0)
 			{
-				ulValue = va_arg(vaArgP, unsigned long);		// Get the value from the varargs.
-				ulPos = 0;		// Reset the buffer position.
-				ulBase = 16;			// Set the base to 16.
-
-				// Indicate that the value is positive so that a minus sign
-				// isn't inserted.
-				ulNeg = 0;
-
-				// Determine the number of digits in the string version of
-				// the value.
-				convert:
-				for(ulIdx = 1;
-						(((ulIdx * ulBase) <= ulValue) &&
-								(((ulIdx * ulBase) / ulBase) == ulIdx));
-						ulIdx *= ulBase, ulCount--);
-
-				// If the value is negative, reduce the count of padding
-				// characters needed.
-				if(ulNeg)
-					ulCount--;
-
-				// If the value is negative and the value is padded with
-				// zeros, then place the minus sign before the padding.
-				if(ulNeg && (cFill == '0'))
-				{
-					pcBuf[ulPos++] = '-';			// Place the minus sign in the output buffer.
+				cSign = '-';
+				ui32Value = -(uint32_t)i32Value;
+			}
+			else
+			{
+				cSign = cPositive;
+				ui32Value = i32Value;
+			}
+			pcStr = Oled_format_dec(ui32Value, &pcBuf[sizeof(pcBuf)]);
+			break;
+
+		case 'u':
+			pcStr = Oled_format_dec(va_arg(vaArgP, unsigned int), &pcBuf[sizeof(pcBuf)]);
+			break;
+
+		case 'x':
+			pcStr = Oled_format_hex(va_arg(vaArgP, unsigned int), &pcBuf[sizeof(pcBuf)], g_pcHex);
+			break;
+
+		case 'X':
+			pcStr = Oled_format_hex(va_arg(vaArgP, unsigned int), &pcBuf[sizeof(pcBuf)],
+									g_pcHexUpper);
+			break;
+
+		case 'p':
+			pcStr = Oled_format_hex((uint32_t)(uintptr_t)va_arg(vaArgP, void *),
+									&pcBuf[sizeof(pcBuf)], g_pcHex);
+			break;
+
+		case 'f':
+		case 'F':
+			cSign = cPositive;
+			pcStr = Oled_format_float(va_arg(vaArgP, double), (i16Prec < 0) ? 6 : i16Prec,
+									  &pcBuf[sizeof(pcBuf)], &cSign);
+			if((*pcStr < '0') || (*pcStr > '9'))	//nan, inf: no zero padding
+				ui8Flags &= ~FORMAT_ZERO;
+			break;
+
+		case 's':
+			pcStr = va_arg(vaArgP, char *);
+			for(ui16Len = 0; (pcStr[ui16Len] != '\0') &&
+					((i16Prec < 0) || (ui16Len < (uint16_t)i16Prec)); ui16Len++);
+			pcEnd = pcStr + ui16Len;
+			ui8Flags &= ~FORMAT_ZERO;
+			break;
+
+		case '%':
+			pcStr = "%";
+			pcEnd = pcStr + 1;
+			ui16Width = 0;
+			break;
+
+		default:
+			pcStr = "ERROR";		// Indicate an error.
+			pcEnd = pcStr + 5;
+			ui16Width = 0;
+			break;
+		}
 
-					// The minus sign has been placed, so turn off the
-					// negative flag.
-					ulNeg = 0;
-				}
+		// Padding: [spaces][sign][zeros]value[spaces]
+		ui16Len = (pcEnd - pcStr) + (cSign ? 1 : 0);
+		ui16Pad = (ui16Width > ui16Len) ? ui16Width - ui16Len : 0;
+		ui16Zero = 0;
+		if((ui8Flags & FORMAT_ZERO) && !(ui8Flags & FORMAT_LEFT))
+		{
+			ui16Zero = ui16Pad;
+			ui16Pad = 0;
+		}
 
-				// Provide additional padding at the beginning of the
-				// string conversion if needed.
-				if((ulCount > 1) && (ulCount < 16))
-				{
-					for(ulCount--; ulCount; ulCount--)
-						pcBuf[ulPos++] = cFill;
-				}
+		if(!(ui8Flags & FORMAT_LEFT))
+			Oled_format_pad(pfnOut, pvCtx, ' ', ui16Pad);
+		if(cSign)
+			pfnOut(&cSign, 1, pvCtx);
+		Oled_format_pad(pfnOut, pvCtx, '0', ui16Zero);
+		pfnOut(pcStr, pcEnd - pcStr, pvCtx);
+		if(ui8Flags & FORMAT_LEFT)
+			Oled_format_pad(pfnOut, pvCtx, ' ', ui16Pad);
+	}
+}
 
-				// If the value is negative, then place the minus sign
-				// before the number.
-				if(ulNeg)
-					pcBuf[ulPos++] = '-';			// Place the minus sign in the output buffer.
+/******************************************************************************
+ * Oled_format_dec - convert an unsigned value to decimal digits
+ * Every digit is computed with a multiplication by the reciprocal of 10
+ * (a single UMULL instruction) instead of a division and a modulo.
+ *
+ * Parameter:
+ * 	ui32Value: the value
+ * 	pcEnd	 : end of the output buffer, the digits are written backward
+ *
+ * Return: pointer to the first digit
+ *****************************************************************************/
+static char *Oled_format_dec(uint32_t ui32Value, char *pcEnd)
+{
+	uint32_t ui32Quot;
 
-				// Convert the value into a string.
-				for(; ulIdx; ulIdx /= ulBase)
-					pcBuf[ulPos++] = g_pcHex[(ulValue / ulIdx) % ulBase];
+	do
+	{
+		ui32Quot = (uint32_t)(((uint64_t)ui32Value * 0xCCCCCCCDu) >> 35);	// ui32Value / 10
+		*--pcEnd = '0' + (char)(ui32Value - ui32Quot * 10);
+		ui32Value = ui32Quot;
+	} while(ui32Value);
 
-				Oled_Putstring(pcBuf, ulPos);		// Write the string.
+	return pcEnd;
+}
 
-				// This command has been handled.
-				break;
-			}
+/******************************************************************************
+ * Oled_format_hex - convert an unsigned value to hexadecimal digits
+ *
+ * Parameter:
+ * 	ui32Value: the value
+ * 	pcEnd	 : end of the output buffer, the digits are written backward
+ * 	pcDigits : the 16 digit characters (lower or upper case)
+ *
+ * Return: pointer to the first digit
+ *****************************************************************************/
+static char *Oled_format_hex(uint32_t ui32Value, char *pcEnd, const char *pcDigits)
+{
+	do
+	{
+		*--pcEnd = pcDigits[ui32Value & 0x0F];
+		ui32Value >>= 4;
+	} while(ui32Value);
 
-			// Handle the %% command.
-			case '%':
-			{
-				Oled_Putstring(pcString - 1, 1);		// Simply write a single %.
+	return pcEnd;
+}
 
-				// This command has been handled.
-				break;
-			}
+/******************************************************************************
+ * Oled_format_float - convert a floating point value to fixed-point digits
+ * No floating point operation is used (the Cortex M4F has a single precision
+ * FPU only): the IEEE-754 double is split into its mantissa and exponent,
+ * the integer part is the mantissa shifted right and the fraction bits are
+ * scaled by 10^precision with integer multiplies, rounded half away from
+ * zero. Both parts are converted with Oled_format_dec. Values which do not
+ * fit in 32 bits once rounded are printed as "inf", NaN as "nan".
+ *
+ * Parameter:
+ * 	dValue	: the value
+ * 	i16Prec	: number of digits after the decimal point (0 to 9)
+ * 	pcEnd	: end of the output buffer (at least 21 bytes), the digits are
+ * 	written backward
+ * 	pcSign	: returned sign character, '-' for a negative value
+ *
+ * Return: pointer to the first character
+ *****************************************************************************/
+static char *Oled_format_float(double dValue, int16_t i16Prec, char *pcEnd, char *pcSign)
+{
+	union
+	{
+		double d;
+		uint64_t u;
+	} uValue;
+	uint64_t ui64Mant, ui64Frac, ui64Low;
+	uint32_t ui32Int, ui32Frac, ui32Pow;
+	uint16_t ui16Exp, ui16Shift;
+	const char *pcText = 0;
+	char *pcFrac;
+
+	uValue.d = dValue;
+	ui16Exp = (uValue.u >> 52) & 0x7FF;
+	ui64Mant = uValue.u & 0x000FFFFFFFFFFFFFULL;
+
+	if((uValue.u >> 63) && (ui16Exp || ui64Mant))
+		*pcSign = '-';
+	if(i16Prec > 9)
+		i16Prec = 9;
+	ui32Pow = g_pui32Pow10[i16Prec];
+
+	if(ui16Exp == 0x7FF)
+		pcText = ui64Mant ? "nan" : "inf";
+	else if(ui16Exp >= 1023 + 32)		// 2^32 or more
+		pcText = "inf";
+	else
+	{
+		// value = mantissa * 2^-shift, shift is 21 to 1074
+		if(ui16Exp)
+			ui64Mant |= 1ULL << 52;
+		else
+			ui16Exp = 1;				// denormal
+		ui16Shift = 1075 - ui16Exp;
+		ui32Int = (ui16Shift < 64) ? (uint32_t)(ui64Mant >> ui16Shift) : 0;
+		ui64Frac = (ui16Shift < 64) ? ui64Mant & ((1ULL << ui16Shift) - 1) : ui64Mant;
+
+		// ui32Frac = round(fraction bits * 10^precision / 2^shift). The product
+		// takes up to 83 bits: above a shift of 32 it is made of 2 multiplies
+		// and kept as (product >> 32, low 32 bits)
+		if(ui16Shift < 32)
+			ui32Frac = (uint32_t)((ui64Frac * ui32Pow + (1UL << (ui16Shift - 1))) >> ui16Shift);
+		else
+		{
+			ui64Low = (ui64Frac & 0xFFFFFFFF) * ui32Pow;
+			ui64Frac = (ui64Frac >> 32) * ui32Pow + (ui64Low >> 32);
+			if(ui16Shift == 32)
+				ui32Frac = (uint32_t)(ui64Frac + (((ui64Low & 0xFFFFFFFF) + 0x80000000) >> 32));
+			else if(ui16Shift - 32 < 64)
+				ui32Frac = (uint32_t)((ui64Frac + (1ULL << (ui16Shift - 33))) >> (ui16Shift - 32));
+			else
+				ui32Frac = 0;
+		}
+		if(ui32Frac >= ui32Pow)			// rounded up to the next integer
+		{
+			ui32Frac -= ui32Pow;
+			if(++ui32Int == 0)
+				pcText = "inf";
+		}
+	}
 
-			// Handle all other commands.
-			default:
-			{
-				Oled_Putstring("ERROR", 5);		// Indicate an error.
+	if(pcText)
+	{
+		pcEnd -= 3;
+		pcEnd[0] = pcText[0];
+		pcEnd[1] = pcText[1];
+		pcEnd[2] = pcText[2];
+		return pcEnd;
+	}
 
-				// This command has been handled.
-				break;
-			}
-			}
-		}
+	if(i16Prec)
+	{
+		// Fraction digits, including the leading zeros
+		pcFrac = Oled_format_dec(ui32Frac, pcEnd);
+		while(pcFrac > pcEnd - i16Prec)
+			*--pcFrac = '0';
+		*--pcFrac = '.';
+		pcEnd = pcFrac;
+	}
+	return Oled_format_dec(ui32Int, pcEnd);
+}
+
+/******************************************************************************
+ * Oled_format_pad - write a number of fill characters
+ *
+ * Parameter:
+ * 	pfnOut	: output function
+ * 	pvCtx	: context passed to the output function
+ * 	cFill	: fill character (' ' or '0')
+ * 	ui16Count: number of characters
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_format_pad(tOledOutput pfnOut, void *pvCtx, char cFill, uint16_t ui16Count)
+{
+	static const char pcSpaces[] = "        ", pcZeros[] = "00000000";
+	const char *pcFill = (cFill == '0') ? pcZeros : pcSpaces;
+	uint8_t ui8Len;
+
+	while(ui16Count)
+	{
+		ui8Len = (ui16Count > 8) ? 8 : ui16Count;
+		pfnOut(pcFill, ui8Len, pvCtx);
+		ui16Count -= ui8Len;
 	}
-	va_end(vaArgP);	// End the varargs processing.
 }
 
 /******************************************************************************
@@ -828,80 +1312,725 @@ void Oled_Contrast(uint8_t Value)
 
 /******************************************************************************
  * Print a single char to Oled
- * char size: 6x8
+ * Characters which are not in the current font are ignored.
  *
  * Parameter:
- * 	c: an ASCII character
+ * 	code: a character (Unicode code point)
  *
  * Return: none
  *****************************************************************************/
-static void Oled_Putchar(char c)
+static void Oled_Putchar(uint16_t code)
 {
-	if((c >= 0x20) && (c <= 0x7f))
+	static const uint8_t space = 0x00;
+	const uint8_t *glyph;
+	int16_t index;
+	uint8_t w, h;
+
+	index = Oled_find_glyph(CurrentFont, code);
+	if (index < 0)
+		return;
+
+	w = Oled_glyph_data(CurrentFont, index, &glyph);
+	h = CurrentFont->heightPages;
+
+	if (textScale > 1)
 	{
-		// char i;
-		c -= CurrentFont->startChar;
-		// for(i = 0; i < 6; i++)
-			// Oled_Write(&ASCII[c][i], 1);
-		//treat character as a image whose size determined by their descriptor
-		Oled_DrawBitmap(currentX, currentY, 1,CurrentFont->heightPages,
-								&CurrentFont->data[0]);//add 1-pixel-wide space
-		Oled_DrawBitmap(currentX+1, currentY, CurrentFont->charInfo[c].widthBits,
-							  CurrentFont->heightPages,
-						&CurrentFont->data[CurrentFont->charInfo[c].offset]);
+		for (index = 0; (index < textScale) && (currentX + index < OLED_COLUMNSIZE); index++)
+			Oled_DrawColumn(currentX + index, currentY,
+							(h * textScale > OLED_HEIGHT) ? OLED_HEIGHT : h * textScale,
+							&space, 0);
+		Oled_draw_scaled_glyph(currentX + textScale, currentY, w, h, glyph,
+							   CurrentFont->format == FONT_FORMAT_RLE, CurrentFont->yShift);
+		currentX += (1 + w) * textScale;
+		return;
 	}
-	currentX += 1 + CurrentFont->charInfo[c].widthBits;
+
+	//add 1-pixel-wide space, the column is cleared without reading font data
+	Oled_DrawColumn(currentX, currentY, h, &space, 0);
+	if (CurrentFont->format == FONT_FORMAT_RLE)
+		Oled_draw_rle_glyph(currentX + 1, currentY, w, h, glyph, CurrentFont->yShift);
+	else
+		Oled_draw_glyph(currentX + 1, currentY, w, h, glyph, w, CurrentFont->yShift);
+
+	currentX += 1 + w;
 }
 
 /******************************************************************************
- * Print a string to Oled
+ * Oled_find_glyph - find the glyph index of a character
+ * A font without ranges is a single range from startChar to endChar.
+ * In a sparse font, the last range found is tried first (a text is usually
+ * written in one script), then the sorted range table is binary searched.
  *
  * Parameter:
- * 	pcBuf :  input string. Note that this is a constant string
- * 	ui8Len: Length of a string
+ * 	font: the font
+ * 	code: a character (Unicode code point)
  *
- * Return: none
+ * Return: index of the glyph in the font, -1 if the character is not in the
+ * font
  *****************************************************************************/
-static void Oled_Putstring(const char *pcBuf, uint8_t ui8Len)
+static int16_t Oled_find_glyph(const FONT_INFO *font, uint16_t code)
 {
-	uint8_t i;
-	for(i = 0; i < ui8Len; i++)
+	const FONT_RANGE *range;
+	uint8_t lo, hi, mid;
+
+	if (!font->ranges)
+	{
+		if ((code < font->startChar) || (code > font->endChar))
+			return -1;
+		return code - font->startChar;
+	}
+
+	if (rangeFont == font)
+	{
+		range = &font->ranges[rangeIndex];
+		if ((code >= range->first) && (code <= range->last))
+			return range->index + code - range->first;
+	}
+
+	lo = 0;
+	hi = font->rangeCount;
+	while (lo < hi)
 	{
-		Oled_Putchar(*pcBuf);
-		pcBuf++;
+		mid = (lo + hi) / 2;
+		range = &font->ranges[mid];
+		if (code < range->first)
+			hi = mid;
+		else if (code > range->last)
+			lo = mid + 1;
+		else
+		{
+			rangeFont = font;
+			rangeIndex = mid;
+			return range->index + code - range->first;
+		}
 	}
+	return -1;
 }
 
 /******************************************************************************
- * Update part of the screen from internal buffer to Oled
- * Tips: to Update whole screen, use:
- * 	Oled_UpdateScreen(WHOLE_SCREEN);
+ * Oled_glyph_data - get the width and the data of a glyph
+ * A monospace font without charInfo has a fixed glyph size, so the glyph
+ * data is found without any descriptor.
  *
  * Parameter:
- * - start_x, start_y: upper left pixel
- * - width: width of the update area (bit)
- * - height: height of the update area (bit)
+ * 	font : the font
+ * 	index: glyph index (from Oled_find_glyph)
+ * 	data : returned glyph data (can be null)
  *
- * Return: none
+ * Return: the glyph width in pixel
  *****************************************************************************/
-// static void Oled_UpdateScreen(void)
-void Oled_UpdateScreen(uint8_t start_x, uint8_t start_y, uint8_t width, uint8_t height)
+static uint8_t Oled_glyph_data(const FONT_INFO *font, int16_t index, const uint8_t **data)
 {
-	 uint8_t i, j;
+	const FONT_CHAR_INFO *info;
 
-	 // The screen is actually updated from the page start_y/8 to (start_y + height)/8 + 1
-	 //page since the Oled hardware is page orientation. (1 page = 8 line)
-	 for (i = start_y/8; i < (height/8) ; i++)	//convert to byte-based data
-	 {
-		 Oled_SetPosition(start_x,i);
-		 SH1106_DC_HIGH();
-		 SH1106_CS_LOW();
+	if (!font->charInfo)
+	{
+		if (data)
+			*data = &font->data[(uint16_t)index * font->monoWidth
+							* ((font->yShift + font->heightPages + 7) / 8)];
+		return font->monoWidth;
+	}
+
+	info = &font->charInfo[index];
+	if (data)
+		*data = &font->data[info->offset];
+	return info->widthBits;
+}
+
+/******************************************************************************
+ * Oled_utf8_next - decode a character of an UTF-8 string
+ * Sequences cut by the end of the string, invalid sequences and code points
+ * above 0xFFFF are decoded as 0xFFFD.
+ *
+ * Parameter:
+ * 	ppui8Str: pointer to the string pointer, moved to the next character
+ * 	pui8End : end of the string
+ *
+ * Return: the character (Unicode code point)
+ *****************************************************************************/
+static uint16_t Oled_utf8_next(const uint8_t **ppui8Str, const uint8_t *pui8End)
+{
+	const uint8_t *str = *ppui8Str;
+	uint32_t code = *str++;
+	uint8_t n;
+
+	if (code < 0x80)				//ASCII
+		n = 0;
+	else if ((code & 0xE0) == 0xC0)	//2 bytes
+	{
+		code &= 0x1F;
+		n = 1;
+	}
+	else if ((code & 0xF0) == 0xE0)	//3 bytes
+	{
+		code &= 0x0F;
+		n = 2;
+	}
+	else if ((code & 0xF8) == 0xF0)	//4 bytes
+	{
+		code &= 0x07;
+		n = 3;
+	}
+	else							//continuation byte without a lead byte
+	{
+		*ppui8Str = str;
+		return 0xFFFD;
+	}
+
+	for (; n; n--, str++)
+	{
+		if ((str >= pui8End) || ((*str & 0xC0) != 0x80))
+		{
+			code = 0xFFFD;
+			break;
+		}
+		code = (code << 6) | (*str & 0x3F);
+	}
+	*ppui8Str = str;
+	return (code > 0xFFFF) ? 0xFFFD : (uint16_t)code;
+}
+
+/******************************************************************************
+ * Oled_print_output - output function of the formatting engine which draws
+ * the text at the current text position
+ *
+ * Parameter:
+ * 	pcBuf : text to draw (UTF-8)
+ * 	ui8Len: number of bytes of the text
+ * 	pvCtx : not used
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_print_output(const char *pcBuf, uint8_t ui8Len, void *pvCtx)
+{
+	(void)pvCtx;
+	Oled_Putstring(pcBuf, ui8Len);
+}
+
+/******************************************************************************
+ * Oled_measure_output - output function of the formatting engine which adds
+ * the width of the text to a counter
+ *
+ * Parameter:
+ * 	pcBuf : text to measure (UTF-8)
+ * 	ui8Len: number of bytes of the text
+ * 	pvCtx : width counter (uint16_t)
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_measure_output(const char *pcBuf, uint8_t ui8Len, void *pvCtx)
+{
+	const uint8_t *str = (const uint8_t *)pcBuf;
+	const uint8_t *end = str + ui8Len;
+	uint16_t *width = (uint16_t *)pvCtx;
+
+	while (str < end)
+		*width += Oled_CharWidth((*str < 0x80) ? *str++ : Oled_utf8_next(&str, end));
+}
+
+/******************************************************************************
+ * Oled_buffer_output - output function of the formatting engine which copies
+ * the text to a buffer, extra text is dropped
+ *
+ * Parameter:
+ * 	pcBuf : text to copy
+ * 	ui8Len: number of bytes of the text
+ * 	pvCtx : destination buffer (OLED_BUFFER_OUTPUT)
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_buffer_output(const char *pcBuf, uint8_t ui8Len, void *pvCtx)
+{
+	OLED_BUFFER_OUTPUT *out = (OLED_BUFFER_OUTPUT *)pvCtx;
+
+	while (ui8Len-- && (out->ui8Pos < out->ui8Size))
+		out->pcBuf[out->ui8Pos++] = *pcBuf++;
+}
+
+/******************************************************************************
+ * Oled_set_rect - fill a rectangle structure, clipped to the screen
+ *
+ * Parameter:
+ * 	pRect : rectangle to fill
+ * 	(x, y): upper left position
+ * 	w	  : width
+ * 	h	  : height
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_set_rect(OLED_RECT *pRect, uint8_t x, uint8_t y, uint16_t w, uint8_t h)
+{
+	if (x >= OLED_COLUMNSIZE)
+		w = 0;
+	else if (w > OLED_COLUMNSIZE - x)
+		w = OLED_COLUMNSIZE - x;
+	if (y >= OLED_HEIGHT)
+		h = 0;
+	else if (h > OLED_HEIGHT - y)
+		h = OLED_HEIGHT - y;
+
+	pRect->x = x;
+	pRect->y = y;
+	pRect->w = w;
+	pRect->h = h;
+}
+
+/******************************************************************************
+ * Oled_row_mask - get the bits of a page covered by the rows [y, y+h)
+ *
+ * Parameter:
+ * 	page: page index (may be outside the screen)
+ * 	y	: first row
+ * 	h	: number of rows
+ *
+ * Return: the mask, 0 if the page is outside the screen or the rows
+ *****************************************************************************/
+static uint8_t Oled_row_mask(int8_t page, uint8_t y, uint8_t h)
+{
+	int16_t first = y - page * 8;
+	int16_t end = first + h;
+	uint8_t mask = 0xFF;
+
+	if ((page < 0) || (page >= OLED_PAGESIZE) || (end <= 0) || (first >= 8))
+		return 0;
+	if (first > 0)
+		mask <<= first;
+	if (end < 8)
+		mask &= 0xFF >> (8 - end);
+	return mask;
+}
+
+/******************************************************************************
+ * Oled_draw_glyph - draw a vertical bitmap (usually a font glyph)
+ * The page masks are calculated once for each page row, then every
+ * page row of the glyph is written column by column:
+ * 	- page aligned glyph: the bytes are copied without masking
+ * 	- other glyph: each destination byte is built by a single shift from 2
+ * 	consecutive glyph rows
+ * Pixels outside the screen are clipped.
+ *
+ * Parameter:
+ * 	(x, y): upper left position of the glyph
+ * 	w	  : number of columns to draw
+ * 	h	  : glyph height in pixel
+ * 	glyph : glyph data (byte orientation: vertical, page rows one after another)
+ * 	stride: number of bytes in a page row of the glyph data
+ * 	top	  : number of blank rows stored above the glyph (pre-shifted glyph)
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_draw_glyph(uint8_t x, uint8_t y, uint8_t w, uint8_t h,
+							const uint8_t *glyph, uint8_t stride, uint8_t top)
+{
+	const uint8_t *cur, *prev;
+	uint8_t *dst;
+	int8_t base, k;
+	uint8_t page, last, shift, nsrc, i, mask, value;
+
+	//sanity check
+	if (x >= OLED_COLUMNSIZE || y >= OLED_HEIGHT || !w || !h)
+		return;
+	if (w > OLED_COLUMNSIZE - x)
+		w = OLED_COLUMNSIZE - x;
+	if (h > OLED_HEIGHT - y)
+		h = OLED_HEIGHT - y;
+
+	shift = (uint8_t)(y - top) % 8;
+	base = ((int8_t)(y - top) - (int8_t)shift) / 8;	//page of the first glyph row
+	nsrc = (top + h + 7) / 8;						//number of glyph pages
+	last = (y + h - 1) / 8;
+
+	for (page = y / 8; page <= last; page++)
+	{
+		mask = Oled_row_mask(page, y, h);
+		k = page - base;	//glyph page whose upper part goes to this page
+		cur = (k < nsrc) ? &glyph[k * stride] : 0;
+		prev = (shift && (k > 0)) ? &glyph[(k - 1) * stride] : 0;
+		dst = &Oled_buff[x][page];
+
+		if (!shift && (mask == 0xFF))	//fast path: straight copy
+		{
+			for (i = 0; i < w; i++, dst += OLED_PAGESIZE)
+				*dst = cur[i];
+		}
+		else
+		{
+			for (i = 0; i < w; i++, dst += OLED_PAGESIZE)
+			{
+				value = cur ? (cur[i] << shift) : 0;
+				if (prev)
+					value |= prev[i] >> (8 - shift);
+				*dst = (*dst & ~mask) | (value & mask);
+			}
+		}
+	}
+}
+
+/******************************************************************************
+ * Oled_draw_rle_glyph - decode a FONT_FORMAT_RLE glyph into the screen buffer
+ * The glyph is decoded byte by byte, in the same order as a raw glyph, and
+ * every byte is written straight to the 1 or 2 pages it covers, so no glyph
+ * buffer is needed. The bits written by a byte are given by a pair of masks
+ * calculated once per glyph page row.
+ * Pixels outside the screen are clipped.
+ *
+ * Parameter:
+ * 	(x, y): upper left position of the glyph
+ * 	w	  : glyph width in pixel
+ * 	h	  : glyph height in pixel
+ * 	rle	  : encoded glyph
+ * 	top	  : number of blank rows stored above the glyph (pre-shifted glyph)
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_draw_rle_glyph(uint8_t x, uint8_t y, uint8_t w, uint8_t h,
+								const uint8_t *rle, uint8_t top)
+{
+	uint8_t lo[OLED_PAGESIZE + 1], hi[OLED_PAGESIZE + 1];
+	uint8_t *dst;
+	int8_t base;
+	uint8_t shift, nsrc, k, i, ctrl, count, value;
+
+	//sanity check
+	if (x >= OLED_COLUMNSIZE || y >= OLED_HEIGHT || !w || !h)
+		return;
+	if (h > OLED_HEIGHT - y)
+		h = OLED_HEIGHT - y;
+
+	shift = (uint8_t)(y - top) % 8;
+	base = ((int8_t)(y - top) - (int8_t)shift) / 8;	//page of the first glyph row
+	nsrc = (top + h + 7) / 8;
+
+	//lo[k]: bits of page (base + k) written by glyph row k
+	//hi[k]: bits of page (base + k + 1) written by glyph row k
+	for (k = 0; k < nsrc; k++)
+	{
+		lo[k] = Oled_row_mask(base + k, y, h) & (0xFF << shift);
+		hi[k] = shift ? (Oled_row_mask(base + k + 1, y, h) & (0xFF >> (8 - shift))) : 0;
+	}
+
+	k = 0;
+	i = 0;
+	value = 0;
+	while (k < nsrc)
+	{
+		//read a packet
+		ctrl = *rle++;
+		if (!(ctrl & 0x80))			//literal bytes
+			count = ctrl + 1;
+		else if (!(ctrl & 0x40))	//zero bytes
+		{
+			count = (ctrl & 0x3F) + 1;
+			value = 0;
+		}
+		else						//repeated byte
+		{
+			count = (ctrl & 0x3F) + 2;
+			value = *rle++;
+		}
+
+		while (count-- && (k < nsrc))
+		{
+			if (!(ctrl & 0x80))
+				value = *rle++;
+			if (x + i < OLED_COLUMNSIZE)
+			{
+				if (lo[k])
+				{
+					dst = &Oled_buff[x + i][base + k];
+					*dst = (*dst & ~lo[k]) | ((value << shift) & lo[k]);
+				}
+				if (hi[k])
+				{
+					dst = &Oled_buff[x + i][base + k + 1];
+					*dst = (*dst & ~hi[k]) | ((value >> (8 - shift)) & hi[k]);
+				}
+			}
+			if (++i == w)
+			{
+				i = 0;
+				k++;
+			}
+		}
+	}
+}
+
+/******************************************************************************
+ * Oled_spread - scale a page byte vertically
+ * Each bit is repeated scale times using the bit spreading tables, so a byte
+ * is scaled with 2 table lookups instead of a loop over its pixels.
+ *
+ * Parameter:
+ * 	value: page byte (up->down: LSB->MSB)
+ * 	scale: scale factor (1 to 4)
+ *
+ * Return: the 8*scale pixels (up->down: LSB->MSB)
+ *****************************************************************************/
+static uint32_t Oled_spread(uint8_t value, uint8_t scale)
+{
+	uint16_t tmp;
+
+	switch (scale)
+	{
+	case 2:
+		return g_pui8Spread2[value & 0x0F] | ((uint16_t)g_pui8Spread2[value >> 4] << 8);
+	case 3:
+		return g_pui16Spread3[value & 0x0F] | ((uint32_t)g_pui16Spread3[value >> 4] << 12);
+	case 4:	//spread twice
+		tmp = g_pui8Spread2[value & 0x0F] | ((uint16_t)g_pui8Spread2[value >> 4] << 8);
+		return g_pui8Spread2[tmp & 0x0F] | ((uint32_t)g_pui8Spread2[(tmp >> 4) & 0x0F] << 8)
+				| ((uint32_t)g_pui8Spread2[(tmp >> 8) & 0x0F] << 16)
+				| ((uint32_t)g_pui8Spread2[tmp >> 12] << 24);
+	default:
+		return value;
+	}
+}
+
+/******************************************************************************
+ * Oled_draw_spread - draw the pixels of a scaled page byte to a column
+ * Only the rows from start to end are drawn.
+ *
+ * Parameter:
+ * 	(x, y): position of the first pixel, y may be negative
+ * 	start : first row to draw
+ * 	end	  : first row not to draw
+ * 	bits  : the pixels (from Oled_spread)
+ * 	scale : scale factor, 8*scale pixels are drawn
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_draw_spread(uint8_t x, int16_t y, uint8_t start, int16_t end,
+							 uint32_t bits, uint8_t scale)
+{
+	uint8_t pixel[4];
+	int16_t n = 8 * scale;
+
+	if (y < start)
+	{
+		bits >>= start - y;
+		n -= start - y;
+		y = start;
+	}
+	if (n > end - y)
+		n = end - y;
+	if ((n <= 0) || (y >= OLED_HEIGHT))
+		return;
+
+	pixel[0] = (uint8_t)bits;
+	pixel[1] = (uint8_t)(bits >> 8);
+	pixel[2] = (uint8_t)(bits >> 16);
+	pixel[3] = (uint8_t)(bits >> 24);
+	Oled_DrawColumn(x, (uint8_t)y, (uint8_t)n, pixel, 1);
+}
+
+/******************************************************************************
+ * Oled_draw_scaled_glyph - draw a glyph scaled by the text scale factor
+ * The glyph is read byte by byte (raw or RLE), every byte is spread once and
+ * drawn to textScale columns.
+ * Pixels outside the screen are clipped.
+ *
+ * Parameter:
+ * 	(x, y): upper left position of the scaled glyph
+ * 	w	  : glyph width in pixel (not scaled)
+ * 	h	  : glyph height in pixel (not scaled)
+ * 	glyph : glyph data
+ * 	rle	  : true for a FONT_FORMAT_RLE glyph
+ * 	top	  : number of blank rows stored above the glyph (pre-shifted glyph)
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_draw_scaled_glyph(uint8_t x, uint8_t y, uint8_t w, uint8_t h,
+								   const uint8_t *glyph, bool rle, uint8_t top)
+{
+	int16_t row, end;
+	uint16_t col;
+	uint32_t bits;
+	uint8_t nsrc, k, i, s, ctrl, count, value;
+
+	//sanity check
+	if (x >= OLED_COLUMNSIZE || y >= OLED_HEIGHT || !w || !h)
+		return;
+
+	end = y + h * textScale;
+	nsrc = (top + h + 7) / 8;
+	ctrl = count = value = 0;
+
+	for (k = 0; k < nsrc; k++)
+	{
+		row = y + ((int16_t)k * 8 - top) * textScale;
+		col = x;
+		for (i = 0; i < w; i++)
+		{
+			if (!rle)
+				value = *glyph++;
+			else
+			{
+				if (!count)	//read a packet
+				{
+					ctrl = *glyph++;
+					if (!(ctrl & 0x80))			//literal bytes
+						count = ctrl + 1;
+					else if (!(ctrl & 0x40))	//zero bytes
+					{
+						count = (ctrl & 0x3F) + 1;
+						value = 0;
+					}
+					else						//repeated byte
+					{
+						count = (ctrl & 0x3F) + 2;
+						value = *glyph++;
+					}
+				}
+				if (!(ctrl & 0x80))
+					value = *glyph++;
+				count--;
+			}
+
+			bits = Oled_spread(value, textScale);
+			for (s = 0; (s < textScale) && (col < OLED_COLUMNSIZE); s++, col++)
+				Oled_draw_spread((uint8_t)col, row, y, end, bits, textScale);
+		}
+	}
+}
+
+/******************************************************************************
+ * Print a string to Oled
+ * The string is UTF-8 encoded, ASCII characters are passed straight to
+ * Oled_Putchar and only multi-byte characters are decoded.
+ *
+ * Parameter:
+ * 	pcBuf :  input string. Note that this is a constant string
+ * 	ui8Len: Length of a string (in bytes)
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_Putstring(const char *pcBuf, uint8_t ui8Len)
+{
+	const uint8_t *str = (const uint8_t *)pcBuf;
+	const uint8_t *end = str + ui8Len;
+
+	while (str < end)
+		Oled_Putchar((*str < 0x80) ? *str++ : Oled_utf8_next(&str, end));
+}
+
+/******************************************************************************
+ * Update part of the screen from internal buffer to Oled
+ * Tips: to Update whole screen, use:
+ * 	Oled_UpdateScreen(WHOLE_SCREEN);
+ *
+ * Parameter:
+ * - start_x, start_y: upper left pixel
+ * - width: width of the update area (bit)
+ * - height: height of the update area (bit)
+ *
+ * Return: none
+ *****************************************************************************/
+// static void Oled_UpdateScreen(void)
+void Oled_UpdateScreen(uint8_t start_x, uint8_t start_y, uint8_t width, uint8_t height)
+{
+	 uint8_t i, j;
+
+	 // The screen is actually updated from the page start_y/8 to the page
+	 // containing the last line, since the Oled hardware is page orientation.
+	 // (1 page = 8 line)
+	 for (i = start_y/8; i < (start_y + height + 7)/8; i++)	//convert to byte-based data
+	 {
+		 Oled_SetPosition(start_x,i);
+		 SH1106_DC_HIGH();
+		 SH1106_CS_LOW();
 		 for(j = start_x; j < (start_x + width); j++)
 		 {
 			 SPI_SendByte(Oled_buff[j][i]);
 		 }
+		 SH1106_CS_HIGH();
 	 }
-	 SH1106_CS_HIGH();
+}
+
+/******************************************************************************
+ * Oled_MarkDirty - add an area to the dirty area of the screen buffer
+ * The dirty area is the bounding box of every marked area, it is sent to the
+ * Oled by Oled_UpdateDirty.
+ *
+ * Parameter:
+ * 	(x, y): upper left position of the area
+ * 	w	  : area width
+ * 	h	  : area height
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_MarkDirty(uint8_t x, uint8_t y, uint8_t w, uint8_t h)
+{
+	uint8_t x1 = (w > OLED_COLUMNSIZE - x) ? OLED_COLUMNSIZE : x + w;
+	uint8_t y1 = (h > OLED_HEIGHT - y) ? OLED_HEIGHT : y + h;
+
+	//sanity check
+	if (x >= OLED_COLUMNSIZE || y >= OLED_HEIGHT || !w || !h)
+		return;
+
+	if (x < dirtyX0)
+		dirtyX0 = x;
+	if (y < dirtyY0)
+		dirtyY0 = y;
+	if (x1 > dirtyX1)
+		dirtyX1 = x1;
+	if (y1 > dirtyY1)
+		dirtyY1 = y1;
+}
+
+/******************************************************************************
+ * Oled_GetDirty - get the dirty area of the screen buffer
+ *
+ * Parameter:
+ * 	pRect: returned dirty area
+ *
+ * Return: false if nothing has been marked since the last update
+ *****************************************************************************/
+bool Oled_GetDirty(OLED_RECT *pRect)
+{
+	if (dirtyX0 >= dirtyX1)
+		return false;
+
+	pRect->x = dirtyX0;
+	pRect->y = dirtyY0;
+	pRect->w = dirtyX1 - dirtyX0;
+	pRect->h = dirtyY1 - dirtyY0;
+	return true;
+}
+
+/******************************************************************************
+ * Oled_UpdateDirty - send the dirty area to the Oled and reset it
+ *
+ * Parameter: none
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_UpdateDirty(void)
+{
+	OLED_RECT rect;
+
+	if (!Oled_GetDirty(&rect))
+		return;
+
+	Oled_UpdateScreen(rect.x, rect.y, rect.w, rect.h);
+	dirtyX0 = OLED_COLUMNSIZE;
+	dirtyY0 = OLED_HEIGHT;
+	dirtyX1 = 0;
+	dirtyY1 = 0;
+}
+
+/******************************************************************************
+ * Oled_GetBuffer - get the screen buffer
+ * For the modules which write whole page bytes (sprites, compressed images).
+ * The byte of column x and page p (rows 8*p to 8*p+7, up->down: LSB->MSB) is
+ * buffer[x * OLED_PAGESIZE + p]. With USE_MULTI_PAGE it is the current page.
+ *
+ * Parameter: none
+ *
+ * Return: first byte of the screen buffer
+ *****************************************************************************/
+uint8_t *Oled_GetBuffer(void)
+{
+	return &Oled_buff[0][0];
 }
 
 /******************************************************************************
@@ -941,6 +2070,420 @@ void Oled_Draw8Pixel(uint8_t x, uint8_t y, uint8_t pixel, uint8_t n_pixel, uint8
 				  Oled_Draw8PixelH(x, y, pixel, n_pixel);
 }
 
+/******************************************************************************
+ * Oled_DrawColumn - draw a column of maximum 64 pixels to screen buffer
+ * The column is given as page bytes (up->down: LSB->MSB), the layout used by
+ * vertical bitmaps and fonts. A page aligned column is copied byte by byte,
+ * otherwise each source byte is shifted once and split into 2 pages.
+ * Pixels outside the screen are clipped.
+ *
+ * Parameter:
+ * 	(x, y): first pixel position
+ * 	h	  : number of pixels to draw
+ * 	pixel : first page byte of the column
+ * 	stride: distance (in bytes) between 2 consecutive page bytes. Use the
+ * 	bitmap width for a vertical bitmap, or 0 to repeat the first byte
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_DrawColumn(uint8_t x, uint8_t y, uint8_t h, const uint8_t *pixel, uint8_t stride)
+{
+	uint8_t *col;
+	uint8_t shift, mask, nsrc, end;
+	uint16_t acc;
+
+	//sanity check
+	if (x >= OLED_COLUMNSIZE || y >= OLED_HEIGHT || !h)
+		return;
+	if (h > OLED_HEIGHT - y)
+		h = OLED_HEIGHT - y;
+
+	col = &Oled_buff[x][y / 8];
+	shift = y % 8;
+
+	if (!shift)	//page aligned: copy whole bytes
+	{
+		for (; h >= 8; h -= 8, pixel += stride)
+			*col++ = *pixel;
+		if (h)
+		{
+			mask = 0xFF >> (8 - h);
+			*col = (*col & ~mask) | (*pixel & mask);
+		}
+		return;
+	}
+
+	//not aligned: each source byte is shifted once and spread over 2 pages
+	nsrc = (h + 7) / 8;
+	end = shift + h;
+	mask = 0xFF << shift;
+	acc = 0;
+	while (end)
+	{
+		if (nsrc)
+		{
+			acc |= (uint16_t)*pixel << shift;
+			pixel += stride;
+			nsrc--;
+		}
+		if (end < 8)
+			mask &= 0xFF >> (8 - end);
+		*col = (*col & ~mask) | ((uint8_t)acc & mask);
+		col++;
+		acc >>= 8;
+		mask = 0xFF;
+		end = (end > 8) ? end - 8 : 0;
+	}
+}
+
+/******************************************************************************
+ * Oled_DrawColumnScaled - draw a column scaled by an integer factor
+ * Every page byte is spread with a table lookup (no loop over the pixels)
+ * and drawn to scale adjacent columns, so each pixel becomes a
+ * scale x scale square.
+ * Pixels outside the screen are clipped.
+ *
+ * Parameter:
+ * 	(x, y): upper left position of the scaled column
+ * 	h	  : number of pixels of the column (not scaled)
+ * 	pixel : first page byte of the column
+ * 	stride: distance (in bytes) between 2 consecutive page bytes
+ * 	scale : scale factor (1 to 4)
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_DrawColumnScaled(uint8_t x, uint8_t y, uint8_t h, const uint8_t *pixel,
+						   uint8_t stride, uint8_t scale)
+{
+	int16_t row, end;
+	uint32_t bits;
+	uint8_t s;
+
+	if (scale <= 1)
+	{
+		Oled_DrawColumn(x, y, h, pixel, stride);
+		return;
+	}
+	if (scale > 4)
+		scale = 4;
+
+	end = y + (int16_t)h * scale;
+	for (row = y; (row < end) && (row < OLED_HEIGHT); row += 8 * scale, pixel += stride)
+	{
+		bits = Oled_spread(*pixel, scale);
+		for (s = 0; (s < scale) && (x + s < OLED_COLUMNSIZE); s++)
+			Oled_draw_spread(x + s, row, y, end, bits, scale);
+	}
+}
+
+/******************************************************************************
+ * Oled_SetFillPattern - set the pattern of the filled shapes
+ * The pattern is used by Oled_DrawBox, Oled_DrawRBox, Oled_DrawDisc,
+ * Oled_DrawFilledEllipse, the filled triangles and polygons, and the large
+ * discs, ellipses and pies. It is tiled from the screen origin, so adjacent
+ * shapes join seamlessly. The pixels of a shape where the pattern is 0 are
+ * cleared.
+ *
+ * Parameter:
+ * 	pattern: 8 column bytes (up->down: LSB->MSB), the byte of column x is
+ * 			 pattern[x % 8]. For example:
+ * 				static const uint8_t grey[8] = FILL_PATTERN_GREY50;
+ * 			 0: solid fill (default)
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_SetFillPattern(const uint8_t *pattern)
+{
+	uint8_t i;
+
+	for (i = 0; i < 8; i++)
+		fillPattern[i] = pattern ? pattern[i] : 0xFF;
+}
+
+/******************************************************************************
+ * Oled_FillByte - get the fill byte of a column span
+ * Oled_DrawColumn shifts its source byte down by y % 8; the pattern byte is
+ * rotated up by the same amount, so the written bits land on the page bytes
+ * of the pattern and a patterned span costs the same as a solid one.
+ * Use it as the repeated byte (stride 0) of Oled_DrawColumn:
+ * 		fill = Oled_FillByte(x, y);
+ * 		Oled_DrawColumn(x, y, h, &fill, 0);
+ *
+ * Parameter:
+ * 	(x, y): first pixel of the span
+ *
+ * Return: source byte for Oled_DrawColumn
+ *****************************************************************************/
+uint8_t Oled_FillByte(uint8_t x, uint8_t y)
+{
+	uint8_t p = fillPattern[x % 8];
+	uint8_t s = y % 8;
+
+	return s ? (uint8_t)((p >> s) | (p << (8 - s))) : p;
+}
+
+/******************************************************************************
+ * Oled_FillColumn - fill the rows top..bottom of a column with the fill
+ * pattern
+ * The span is clipped to the screen and drawn with one masked write per page
+ * byte. All the filled shapes are made of these spans.
+ *
+ * Parameter:
+ * 	x	  : column position (may be outside the screen)
+ * 	top	  : first row (may be outside the screen)
+ * 	bottom: last row (may be outside the screen), nothing is drawn when it
+ * 	is above top
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_FillColumn(int16_t x, int32_t top, int32_t bottom)
+{
+	uint8_t fill;
+
+	if (x < 0 || x >= OLED_COLUMNSIZE)
+		return;
+	if (top < 0)
+		top = 0;
+	if (bottom >= OLED_HEIGHT)
+		bottom = OLED_HEIGHT - 1;
+	if (top > bottom)
+		return;
+
+	fill = Oled_FillByte(x, top);
+	Oled_DrawColumn(x, top, bottom - top + 1, &fill, 0);
+}
+
+/******************************************************************************
+ * Oled_DrawSpan - draw a span of a wide stroke centered on a pixel
+ * Wide lines and circles are made of these spans. The span is clipped to the
+ * screen. A column is written with one masked write per page byte, a row
+ * sets the same bit of each page byte it crosses.
+ *
+ * Parameter:
+ * 	(x, y)	  : center pixel (may be outside the screen)
+ * 	t		  : span length
+ * 	horizontal: true: the span is a row, false: a column
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_DrawSpan(int16_t x, int16_t y, uint16_t t, bool horizontal)
+{
+	const uint8_t fill = 0xFF;
+	int16_t first, last;
+	uint8_t bit;
+
+	if (horizontal)
+	{
+		first = x - (t - 1) / 2;
+		last = x + t / 2;
+		if (y < 0 || y >= OLED_HEIGHT)
+			return;
+		if (first < 0)
+			first = 0;
+		if (last >= OLED_COLUMNSIZE)
+			last = OLED_COLUMNSIZE - 1;
+		bit = 1 << (y % 8);
+		for (; first <= last; first++)
+			Oled_buff[first][y / 8] |= bit;
+	}
+	else
+	{
+		first = y - (t - 1) / 2;
+		last = y + t / 2;
+		if (x < 0 || x >= OLED_COLUMNSIZE)
+			return;
+		if (first < 0)
+			first = 0;
+		if (last >= OLED_HEIGHT)
+			last = OLED_HEIGHT - 1;
+		if (first <= last)
+			Oled_DrawColumn(x, first, last - first + 1, &fill, 0);
+	}
+}
+
+/******************************************************************************
+ * Oled_FloodFill - fill the area of cleared pixels around a pixel
+ * Scanline fill over the columns of the screen buffer: the run of cleared
+ * pixels of a column is found by whole page bytes when possible and filled
+ * with Oled_DrawColumn, then the rows it covers are scanned in the next
+ * columns. The runs waiting to be scanned are kept in the caller's stack;
+ * when it is full the fill stops and the area is only partly filled.
+ * The area (4-connected) is filled solid, the fill pattern is not used. Only
+ * the columns and rows that were filled are marked dirty.
+ *
+ * Parameter:
+ * 	(x, y): pixel inside the area
+ * 	stack : stack of column runs, 32 entries are enough for most shapes
+ * 	size  : number of entries of the stack
+ *
+ * Return: true if the whole area is filled, false if the stack overflowed
+ *****************************************************************************/
+bool Oled_FloodFill(uint8_t x, uint8_t y, OLED_FILL_SPAN *stack, uint16_t size)
+{
+	const uint8_t fill = 0xFF;
+	OLED_FILL_SPAN span;
+	uint16_t n = 0;
+	uint8_t x0, y0, x1, y1;
+	uint8_t top, bottom;
+	int16_t row;
+	bool ok = true;
+
+	//sanity check
+	if (x >= OLED_COLUMNSIZE || y >= OLED_HEIGHT || ((Oled_buff[x][y / 8] >> (y % 8)) & 1))
+		return true;
+
+	//the seed is a run scanned from both sides
+	x0 = x1 = x;
+	y0 = y1 = y;
+	span.x = x;
+	span.top = y;
+	span.bottom = y;
+	span.dir = 0;
+	while (1)
+	{
+		//fill each run of cleared pixels found in the scanned rows
+		row = Oled_next_clear(Oled_buff[span.x], span.top, span.bottom);
+		while (row >= 0)
+		{
+			top = Oled_run_top(Oled_buff[span.x], row);
+			bottom = Oled_run_bottom(Oled_buff[span.x], row);
+			Oled_DrawColumn(span.x, top, bottom - top + 1, &fill, 0);
+
+			if (span.x < x0)
+				x0 = span.x;
+			if (span.x > x1)
+				x1 = span.x;
+			if (top < y0)
+				y0 = top;
+			if (bottom > y1)
+				y1 = bottom;
+
+			//forward: the whole run; backward: the part beyond the scanned rows
+			if (n + 3 > size)
+				ok = false;
+			else
+			{
+				if ((span.dir >= 0) && (span.x < OLED_COLUMNSIZE - 1))
+				{
+					stack[n].x = span.x + 1;
+					stack[n].top = top;
+					stack[n].bottom = bottom;
+					stack[n++].dir = 1;
+				}
+				if ((span.dir <= 0) && (span.x > 0))
+				{
+					stack[n].x = span.x - 1;
+					stack[n].top = top;
+					stack[n].bottom = bottom;
+					stack[n++].dir = -1;
+				}
+				if (span.dir && (span.x - span.dir >= 0) && (span.x - span.dir < OLED_COLUMNSIZE))
+				{
+					if (top < span.top)
+					{
+						stack[n].x = span.x - span.dir;
+						stack[n].top = top;
+						stack[n].bottom = span.top - 1;
+						stack[n++].dir = -span.dir;
+					}
+					if (bottom > span.bottom)
+					{
+						stack[n].x = span.x - span.dir;
+						stack[n].top = span.bottom + 1;
+						stack[n].bottom = bottom;
+						stack[n++].dir = -span.dir;
+					}
+				}
+			}
+
+			row = (bottom + 1 <= span.bottom) ? Oled_next_clear(Oled_buff[span.x], bottom + 1, span.bottom) : -1;
+		}
+
+		if (!n)
+			break;
+		span = stack[--n];
+	}
+
+	Oled_MarkDirty(x0, y0, x1 - x0 + 1, y1 - y0 + 1);
+	return ok;
+}
+
+/******************************************************************************
+ * Oled_run_top - find the first row of a run of cleared pixels
+ * This function support the flood fill function (Oled_FloodFill)
+ * A whole page byte of cleared pixels is skipped at once.
+ *
+ * Parameter:
+ * 	col: the page bytes of the column
+ * 	y  : a cleared pixel of the run
+ *
+ * Return: first row of the run
+ *****************************************************************************/
+static uint8_t Oled_run_top(const uint8_t *col, uint8_t y)
+{
+	while (y)
+	{
+		if (!(y % 8) && !col[y / 8 - 1])
+			y -= 8;
+		else if (!((col[(y - 1) / 8] >> ((y - 1) % 8)) & 1))
+			y--;
+		else
+			break;
+	}
+	return y;
+}
+
+/******************************************************************************
+ * Oled_run_bottom - find the last row of a run of cleared pixels
+ * This function support the flood fill function (Oled_FloodFill)
+ * A whole page byte of cleared pixels is skipped at once.
+ *
+ * Parameter:
+ * 	col: the page bytes of the column
+ * 	y  : a cleared pixel of the run
+ *
+ * Return: last row of the run
+ *****************************************************************************/
+static uint8_t Oled_run_bottom(const uint8_t *col, uint8_t y)
+{
+	while (y < OLED_HEIGHT - 1)
+	{
+		if ((y % 8 == 7) && !col[y / 8 + 1])
+			y += 8;
+		else if (!((col[(y + 1) / 8] >> ((y + 1) % 8)) & 1))
+			y++;
+		else
+			break;
+	}
+	return y;
+}
+
+/******************************************************************************
+ * Oled_next_clear - find the first cleared pixel of a column in a range
+ * This function support the flood fill function (Oled_FloodFill)
+ * A whole page byte of set pixels is skipped at once.
+ *
+ * Parameter:
+ * 	col	  : the page bytes of the column
+ * 	y	  : first row of the range
+ * 	bottom: last row of the range
+ *
+ * Return: the row of the pixel, -1 if every pixel is set
+ *****************************************************************************/
+static int16_t Oled_next_clear(const uint8_t *col, uint8_t y, uint8_t bottom)
+{
+	while (y <= bottom)
+	{
+		if (!(y % 8) && (col[y / 8] == 0xFF))
+			y += 8;
+		else if (!((col[y / 8] >> (y % 8)) & 1))
+			return y;
+		else
+			y++;
+	}
+	return -1;
+}
+
 /******************************************************************************
  * Oled_Draw8PixelV - draw maximum 8 pixels in vertical direction
  *
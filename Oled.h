@@ -21,6 +21,7 @@
 #define OLED_H_
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdarg.h>
 #include "font/bitmap_db.h"
 #include "font/font_include.h"
 //*******************************Definitions***********************************
@@ -74,6 +75,43 @@
 #define VERTICAL									true
 #define HORIZONTAL									false
 
+/* Oled_SetFillPattern: initializers of 8x8 patterns (8 column bytes, up->down: LSB->MSB) */
+#define FILL_PATTERN_GREY50							{0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA}
+#define FILL_PATTERN_GREY25							{0x11, 0x00, 0x44, 0x00, 0x11, 0x00, 0x44, 0x00}
+#define FILL_PATTERN_HATCH							{0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80}
+#define FILL_PATTERN_GRID							{0xFF, 0x11, 0x11, 0x11, 0xFF, 0x11, 0x11, 0x11}
+
+/* Oled_printfAligned */
+#define TEXT_ALIGN_LEFT								0x00
+#define TEXT_ALIGN_CENTER							0x01
+#define TEXT_ALIGN_RIGHT							0x02
+#define TEXT_ALIGN_TOP								0x00
+#define TEXT_ALIGN_MIDDLE							0x04
+#define TEXT_ALIGN_BOTTOM							0x08
+#define OLED_TEXT_BUFSIZE							64		//max characters formatted at once (including '\0')
+
+/* Oled_line.c */
+#define LINE_PATTERN_SOLID							0xFFFF	//dash patterns for Oled_SetLineStyle
+#define LINE_PATTERN_DOTTED							0x5555
+#define LINE_PATTERN_DASHED							0x0F0F
+
+/* Oled_label.c */
+#define LABEL_MAX_CHARS								16		//max characters in a label
+
+/* Oled_textbox.c */
+#define TEXTBOX_MAX_LINES							32		//max lines laid out in a text box
+
+/* Oled_bitmap.c */
+#define BITMAP_ROP_COPY								0		//raster operations of Oled_DrawBitmapRop: pixel = image
+#define BITMAP_ROP_OR								1		//set the pixels of the image (0: transparent)
+#define BITMAP_ROP_AND								2		//clear the pixels where the image is 0
+#define BITMAP_ROP_XOR								3		//invert the pixels of the image
+#define BITMAP_ROP_ERASE							4		//clear the pixels of the image
+#define BITMAP_ROP_INVERT							5		//pixel = inverted image
+
+/* Oled_sprite.c */
+#define SPRITE_MAX_AREAS							8		//max areas updated by one Oled_SceneUpdate
+
 /* Oled_circle.c */
 /* Oled_ellipse.c */
 #define DRAW_UPPER_RIGHT 0x01
@@ -82,6 +120,19 @@
 #define DRAW_LOWER_RIGHT  0x08
 #define DRAW_ALL (DRAW_UPPER_RIGHT|DRAW_UPPER_LEFT|DRAW_LOWER_RIGHT|DRAW_LOWER_LEFT)
 
+/* Oled_arc.c */
+#define ARC_MAX_RADIUS								16383	//max radius of the large circles and ellipses
+
+/* Oled_trig.c */
+#define OLED_Q15_ONE								32768	//1.0 in Q15 (transform factors)
+
+/* Oled_polygon.c */
+#define POLYGON_EVEN_ODD							0		//fill rule: even-odd
+#define POLYGON_NONZERO								1		//fill rule: nonzero winding
+#ifndef POLYGON_MAX_POINTS
+#define POLYGON_MAX_POINTS							16		//max points of a filled polygon, up to 255 (about 24 bytes of stack each)
+#endif
+
 /* Oled_page.c */
 //#define USE_MULTI_PAGE
 #ifdef USE_MULTI_PAGE
@@ -89,6 +140,101 @@
 #endif
 //*****************************************************************************
 
+//*********************************Data types**********************************
+// A point, may be outside the screen
+typedef struct
+{
+	int16_t x;
+	int16_t y;
+} OLED_POINT;
+
+// A screen area in pixel
+typedef struct
+{
+	uint8_t x;	// upper left x-coordinate
+	uint8_t y;	// upper left y-coordinate
+	uint8_t w;	// width
+	uint8_t h;	// height
+} OLED_RECT;
+
+// A column run waiting in the stack of Oled_FloodFill
+typedef struct
+{
+	uint8_t x;			// column to scan
+	uint8_t top;		// first row to scan
+	uint8_t bottom;		// last row to scan
+	int8_t dir;			// scan direction: 1 to the right, -1 to the left
+} OLED_FILL_SPAN;
+
+// A text label which only redraws the characters that changed
+typedef struct
+{
+	uint8_t x;							// upper left x-coordinate
+	uint8_t y;							// upper left y-coordinate
+	uint8_t maxWidth;					// the text is cut at this width
+	FONT_INFO *font;					// font of the label
+	uint8_t len;						// number of characters on screen
+	uint16_t text[LABEL_MAX_CHARS];		// characters on screen (Unicode code points)
+	uint8_t xoff[LABEL_MAX_CHARS + 1];	// x offset of each character, xoff[len] is the text width
+} OLED_LABEL;
+
+// A word-wrapped text in a box, the line breaks are computed once
+typedef struct
+{
+	OLED_RECT box;							// area of the text box
+	FONT_INFO *font;						// font of the text
+	const char *text;						// the text (UTF-8), owned by the caller
+	uint8_t lines;							// number of lines
+	uint8_t top;							// first visible line
+	uint16_t lineStart[TEXTBOX_MAX_LINES + 1];	// offset of each line in text, lineStart[lines] is the end
+} OLED_TEXTBOX;
+
+// A sprite: a bitmap moved over a scene background. The fields are set with
+// the Oled_Sprite... functions, the scene redraws what changed.
+typedef struct OLED_SPRITE_s
+{
+	const uint8_t *bitmap;			// image (Oled_DrawBitmap layout: vertical bytes, page by page)
+	const uint8_t *mask;			// opaque pixels (same layout), 0: the whole rectangle is opaque
+	int16_t x;						// upper left x-coordinate (may be outside the screen)
+	int16_t y;						// upper left y-coordinate (may be outside the screen)
+	uint8_t w;						// width
+	uint8_t h;						// height
+	uint8_t z;						// drawing order, higher z on top
+	bool visible;					// drawn or hidden
+	bool changed;					// redrawn by the next Oled_SceneUpdate
+	bool drawn;						// the area below is on screen
+	OLED_RECT area;					// area on screen (x, page, columns, pages) when drawn
+	struct OLED_SPRITE_s *next;		// next sprite of the scene (by z)
+} OLED_SPRITE;
+
+// Sprites over a background, in z order
+typedef struct
+{
+	const uint8_t *background;		// full screen image (Oled_DrawBitmap layout), 0: cleared screen
+	OLED_SPRITE *first;				// lowest sprite
+} OLED_SCENE;
+
+// Player of a delta encoded animation (tools/animconv.py)
+typedef struct
+{
+	const uint8_t *data;			// animation in flash
+	const uint8_t *next;			// record of the next frame
+	uint16_t frame;					// index of the next frame
+	uint32_t due;					// time the next frame is shown (ms)
+	bool playing;					// false once the last frame is shown
+} OLED_ANIMATION;
+
+// A 2D affine transform, Q15 fixed point:
+// 	x' = a*x + b*y + tx
+// 	y' = c*x + d*y + ty
+typedef struct
+{
+	int32_t a, b;		// first row of the matrix
+	int32_t c, d;		// second row of the matrix
+	int32_t tx, ty;		// offset
+} OLED_TRANSFORM;
+//*****************************************************************************
+
 //****************************Function prototypes******************************
 void Oled_Command(unsigned char Code);
 void Oled_Init(void);
@@ -105,12 +251,27 @@ void Oled_ReadImage(unsigned char *Image, uint8_t ui8Start_column,
 void Oled_Sleepmode(bool bEnter);
 void Oled_Contrast(uint8_t Value);
 void Oled_UpdateScreen(uint8_t start_x, uint8_t start_y, uint8_t width, uint8_t height);
+void Oled_MarkDirty(uint8_t x, uint8_t y, uint8_t w, uint8_t h);
+bool Oled_GetDirty(OLED_RECT *pRect);
+void Oled_UpdateDirty(void);
+uint8_t *Oled_GetBuffer(void);
 
 void Oled_DrawPixel(uint8_t x, uint8_t y, uint8_t value);
 void Oled_Draw8Pixel(uint8_t x, uint8_t y, uint8_t pixel, uint8_t n_pixel, uint8_t dir_v);
+void Oled_DrawColumn(uint8_t x, uint8_t y, uint8_t h, const uint8_t *pixel, uint8_t stride);
+void Oled_DrawColumnScaled(uint8_t x, uint8_t y, uint8_t h, const uint8_t *pixel,
+						   uint8_t stride, uint8_t scale);
+void Oled_SetFillPattern(const uint8_t *pattern);
+uint8_t Oled_FillByte(uint8_t x, uint8_t y);
+void Oled_FillColumn(int16_t x, int32_t top, int32_t bottom);
+void Oled_DrawSpan(int16_t x, int16_t y, uint16_t t, bool horizontal);
+bool Oled_FloodFill(uint8_t x, uint8_t y, OLED_FILL_SPAN *stack, uint16_t size);
 void Oled_DrawHLine(uint8_t x, uint8_t y, uint8_t w);
 void Oled_DrawVLine(uint8_t x, uint8_t y, uint8_t h);
 void Oled_DrawLine(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2);
+void Oled_SetLineStyle(uint8_t width, uint16_t pattern);
+uint8_t Oled_GetLineWidth(void);
+uint16_t Oled_GetLinePattern(void);
 
 void Oled_DrawFrame(uint8_t x, uint8_t y, uint8_t w, uint8_t h);
 void Oled_DrawRFrame(uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint8_t r);
@@ -123,16 +284,85 @@ void Oled_DrawDisc(uint8_t x0, uint8_t y0, uint8_t rad, uint8_t option);
 void Oled_DrawEllipse(uint8_t x0, uint8_t y0, uint8_t rx, uint8_t ry, uint8_t option);
 void Oled_DrawFilledEllipse(uint8_t x0, uint8_t y0, uint8_t rx, uint8_t ry, uint8_t option);
 
+void Oled_DrawLargeCircle(int16_t x0, int16_t y0, uint16_t rad, uint8_t option);
+void Oled_DrawLargeDisc(int16_t x0, int16_t y0, uint16_t rad, uint8_t option);
+void Oled_DrawLargeEllipse(int16_t x0, int16_t y0, uint16_t rx, uint16_t ry, uint8_t option);
+void Oled_DrawLargeFilledEllipse(int16_t x0, int16_t y0, uint16_t rx, uint16_t ry,
+								 uint8_t option);
+void Oled_DrawArc(int16_t x0, int16_t y0, uint16_t rad, int16_t start, int16_t end);
+void Oled_DrawPie(int16_t x0, int16_t y0, uint16_t rad, int16_t start, int16_t end);
+
 void Oled_DrawPolygon(uint8_t nPoint, ...);
 void Oled_DrawTriangle(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2);
 void Oled_DrawFilledPolygon(uint8_t nPoint, ...);
 void Oled_DrawFilledTriangle(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2);
+void Oled_DrawPolygonArray(const OLED_POINT *points, uint8_t nPoint);
+void Oled_DrawPolyline(const OLED_POINT *points, uint8_t nPoint);
+bool Oled_FillPolygon(const OLED_POINT *points, uint8_t nPoint, uint8_t rule);
+
+void Oled_DrawQuadBezier(const OLED_POINT *points);
+void Oled_DrawCubicBezier(const OLED_POINT *points);
+
+int16_t Oled_Sin(int16_t angle);
+int16_t Oled_Cos(int16_t angle);
+int16_t Oled_Atan2(int32_t y, int32_t x);
+uint32_t Oled_Sqrt(uint64_t n);
+void Oled_TransformIdentity(OLED_TRANSFORM *t);
+void Oled_TransformRotate(OLED_TRANSFORM *t, int16_t angle);
+void Oled_TransformScale(OLED_TRANSFORM *t, int32_t sx, int32_t sy);
+void Oled_TransformTranslate(OLED_TRANSFORM *t, int16_t dx, int16_t dy);
+void Oled_TransformPoints(const OLED_TRANSFORM *t, const OLED_POINT *src, OLED_POINT *dst,
+						  uint8_t nPoint);
 
 void Oled_DrawBitmap(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t *bitmap);
 void Oled_DrawBitmapH(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t *bitmap);
+void Oled_DrawBitmapScaled(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t *bitmap,
+						   uint8_t scale);
+void Oled_DrawBitmapRop(int16_t x, int16_t y, uint8_t w, uint8_t h, const uint8_t *bitmap,
+						const uint8_t *mask, uint8_t rop);
+void Oled_DrawPageRop(uint8_t x, int16_t page, uint8_t shift, const uint8_t *bitmap,
+					  const uint8_t *mask, uint16_t rows, uint8_t n, uint8_t rop);
+void Oled_DrawBitmapRLE(int16_t x, int16_t y, const uint8_t *image, uint8_t rop);
+void Oled_SendBitmapRLE(uint8_t x, uint8_t page, const uint8_t *image);
 
 void Oled_SetFont(FONT_INFO *font);
+FONT_INFO *Oled_GetFont(void);
+void Oled_SetTextScale(uint8_t scale);
+uint8_t Oled_DrawChar(uint8_t x, uint8_t y, uint16_t code);
+uint16_t Oled_NextChar(const char **ppcString);
 void Oled_printf(uint8_t x, uint8_t y, const char *pcString, ...);
+uint8_t Oled_snprintf(char *pcBuf, uint8_t ui8Size, const char *pcString, ...);
+uint8_t Oled_vsnprintf(char *pcBuf, uint8_t ui8Size, const char *pcString, va_list vaArgP);
+uint8_t Oled_CharWidth(uint16_t code);
+uint8_t Oled_FontHeight(void);
+uint16_t Oled_TextWidth(const char *pcString);
+uint16_t Oled_TextWidthf(const char *pcString, ...);
+void Oled_TextBounds(uint8_t x, uint8_t y, const char *pcString, OLED_RECT *pRect);
+void Oled_printfAligned(const OLED_RECT *pBox, uint8_t ui8Align, OLED_RECT *pArea,
+						const char *pcString, ...);
+
+void Oled_LabelInit(OLED_LABEL *label, uint8_t x, uint8_t y, uint8_t maxWidth,
+					FONT_INFO *font);
+void Oled_LabelPrintf(OLED_LABEL *label, const char *pcString, ...);
+
+void Oled_TextBoxInit(OLED_TEXTBOX *textbox, const OLED_RECT *box, FONT_INFO *font);
+void Oled_TextBoxSetText(OLED_TEXTBOX *textbox, const char *text);
+void Oled_TextBoxScroll(OLED_TEXTBOX *textbox, int16_t lines);
+void Oled_TextBoxDraw(OLED_TEXTBOX *textbox);
+uint8_t Oled_TextBoxVisibleLines(const OLED_TEXTBOX *textbox);
+
+void Oled_SceneInit(OLED_SCENE *scene, const uint8_t *background);
+void Oled_SceneAdd(OLED_SCENE *scene, OLED_SPRITE *sprite, uint8_t z);
+void Oled_SceneRedraw(OLED_SCENE *scene);
+void Oled_SceneUpdate(OLED_SCENE *scene);
+void Oled_SpriteInit(OLED_SPRITE *sprite, const uint8_t *bitmap, const uint8_t *mask,
+					 uint8_t w, uint8_t h);
+void Oled_SpriteMove(OLED_SPRITE *sprite, int16_t x, int16_t y);
+void Oled_SpriteSetImage(OLED_SPRITE *sprite, const uint8_t *bitmap, const uint8_t *mask);
+void Oled_SpriteShow(OLED_SPRITE *sprite, bool visible);
+
+void Oled_AnimationStart(OLED_ANIMATION *anim, const uint8_t *data, uint32_t now);
+bool Oled_AnimationUpdate(OLED_ANIMATION *anim, uint32_t now);
 
 #ifdef USE_MULTI_PAGE
 uint8_t Oled_CurentPage(void);
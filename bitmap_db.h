@@ -28,15 +28,47 @@ typedef struct
 	
 } FONT_CHAR_INFO;	
 
+// Font data formats (FONT_INFO's format)
+#define FONT_FORMAT_RAW		0		// glyph bytes stored as is (default)
+#define FONT_FORMAT_RLE		1		// glyph bytes run-length encoded, see below
+
+// A monospace font may omit charInfo: every glyph is monoWidth pixels wide
+// and glyph n starts at byte n * monoWidth * (pages of a glyph) of data.
+//
+// A pre-shifted font stores every glyph yShift (0 to 7) rows lower than it is
+// drawn, with blank rows above, so a glyph has (yShift + heightPages + 7) / 8
+// pages. Text printed at y with (y - yShift) multiple of 8 is then copied
+// without any shift.
+//
+// FONT_FORMAT_RLE: each glyph is a stream of packets, starting at the
+// FONT_CHAR_INFO's offset and decoding to the same bytes as the raw glyph
+// 	0nnnnnnn		: n+1 literal bytes follow
+// 	10nnnnnn		: n+1 zero bytes
+// 	11nnnnnn, b		: byte b repeated n+2 times
+
+// Describes a range of consecutive characters (Unicode code points) of a
+// sparse font. The glyphs of a range follow each other in charInfo.
+typedef struct
+{
+	const uint16_t			first;			// the first code point of the range
+	const uint16_t			last;			// the last code point of the range
+	const uint16_t			index;			// charInfo index of the first code point
+} FONT_RANGE;
+
 // Describes a single font
 typedef struct
 {
-	const uint8_t 			heightPages;	// height, in pages (8 pixels), of the font's characters
+	const uint8_t 			heightPages;	// height, in pixels, of the font's characters (despite the name)
 	const uint8_t 			startChar;		// the first character in the font (e.g. in charInfo and data)
 	const uint8_t 			endChar;		// the last character in the font
 //	const uint8_t			spacePixels;	// number of pixels that a space character takes up
 	const FONT_CHAR_INFO*	charInfo;		// pointer to array of char information
 	const uint8_t*			data;			// pointer to generated array of character visual representation
+	const uint8_t			format;			// format of data (FONT_FORMAT_xxx), FONT_FORMAT_RAW if omitted
+	const FONT_RANGE*		ranges;			// sorted code point ranges, if omitted: startChar to endChar
+	const uint8_t			rangeCount;		// number of ranges
+	const uint8_t			monoWidth;		// glyph width of a monospace font without charInfo (null)
+	const uint8_t			yShift;			// glyphs are stored yShift pixels lower (pre-shifted)
 		
 } FONT_INFO;	
 
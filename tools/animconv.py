@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+"""
+animconv.py - animation compiler for the Oled Graphics library (host tool)
+
+Converts a sequence of monochrome frames to a delta encoded animation for
+Oled_AnimationStart and Oled_AnimationUpdate.
+
+Input:
+    - PBM images (.pbm, plain P1 or raw P4) of the same size, in order, e.g.
+      made with "convert anim.gif -coalesce -monochrome frame%02d.pbm"
+      (black pixels are the lit pixels, see --invert)
+
+Output:
+    The first frame is the keyframe, stored as an Oled_DrawBitmapRLE image.
+    Every other frame is stored as the page bytes that changed since the
+    previous frame: runs of XOR bytes, one run per group of changed columns
+    of a page (runs closer than --gap columns are merged, a run costs 3 bytes
+    of header and a SetPosition on the bus).
+
+Options:
+    --x, --page     position of the animation on the screen (column, page)
+    --delay MS      time between 2 frames, in steps of 10 ms (default 100)
+    --loop          add a last frame back to the keyframe, the player loops
+    --invert        white pixels are the lit pixels
+
+Usage:
+    animconv.py frame*.pbm -o walk.h [--name NAME] [--x X] [--page P] [--loop]
+
+Author: QUANG
+"""
+
+import argparse
+import os
+import re
+import sys
+
+from fontconv import rle_encode, _hex_lines
+from imgconv import read_pbm, to_pages
+
+ANIM_FLAG_LOOP = 0x01
+ANIM_END = 0xFF
+ANIM_DELAY_UNIT = 10    # ms
+
+
+# ---------------------------------------------------------------------------
+# Encoding
+# ---------------------------------------------------------------------------
+def delta_runs(prev, cur, w, pages, gap):
+    """Runs (page, column, XOR bytes) from frame prev to frame cur."""
+    runs = []
+    for page in range(pages):
+        row = [prev[page * w + x] ^ cur[page * w + x] for x in range(w)]
+        x = 0
+        while x < w:
+            if not row[x]:
+                x += 1
+                continue
+            start = end = x
+            while x < w and x - end <= gap:
+                if row[x]:
+                    end = x
+                x += 1
+            runs.append((page, start, row[start:end + 1]))
+            x = end + 1
+    return runs
+
+
+def encode(frames, w, h, x, page, delay, loop, gap):
+    pages = (h + 7) // 8
+    key = [w, h] + rle_encode(frames[0])
+    records = []
+    sequence = frames[1:] + (frames[:1] if loop else [])
+    prev = frames[0]
+    for cur in sequence:
+        record = [delay]
+        for p, column, data in delta_runs(prev, cur, w, pages, gap):
+            record += [p, column, len(data)] + data
+        record.append(ANIM_END)
+        records.append(record)
+        prev = cur
+    count = len(records)
+    header = [count & 0xFF, count >> 8, x, page, ANIM_FLAG_LOOP if loop else 0,
+              len(key) & 0xFF, len(key) >> 8]
+    out = header + key
+    for record in records:
+        out += record
+    return out, records
+
+
+def write_header(path, name, data, w, h, frames, source):
+    guard = re.sub(r'\W', '_', name).upper() + '_H_'
+    raw_size = frames * w * ((h + 7) // 8)
+    out = []
+    out.append('/*')
+    out.append(' * %s - generated by tools/animconv.py from %s' % (name, source))
+    out.append(' * Oled Graphics library')
+    out.append(' *')
+    out.append(' * Format: delta encoded animation, %d frames of %dx%d pixels' % (frames, w, h))
+    out.append(' * Flash: %d bytes (raw %d)' % (len(data), raw_size))
+    out.append(' */')
+    out.append('')
+    out.append('#ifndef %s' % guard)
+    out.append('#define %s' % guard)
+    out.append('')
+    out.append('const uint8_t %s[] = {' % name)
+    out.extend(_hex_lines(data))
+    out.append('};')
+    out.append('')
+    out.append('#endif /* %s */' % guard)
+    with open(path, 'w', newline='\r\n') as f:
+        f.write('\n'.join(out) + '\n')
+    return raw_size
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    ap.add_argument('input', nargs='+', help='PBM frames, in order')
+    ap.add_argument('-o', '--output', required=True, help='output header')
+    ap.add_argument('--name', help='name of the generated array')
+    ap.add_argument('--x', type=int, default=0, help='column of the animation')
+    ap.add_argument('--page', type=int, default=0, help='page of the animation')
+    ap.add_argument('--delay', type=int, default=100, help='ms between 2 frames')
+    ap.add_argument('--loop', action='store_true',
+                    help='turn back to the first frame after the last one')
+    ap.add_argument('--gap', type=int, default=3,
+                    help='merge runs of a page closer than GAP columns')
+    ap.add_argument('--invert', action='store_true',
+                    help='white pixels are the lit pixels')
+    args = ap.parse_args()
+
+    frames = []
+    for path in args.input:
+        w, h, rows = read_pbm(path)
+        if frames and (w, h) != size:
+            sys.exit('%s: %dx%d, the frames must all be %dx%d' % ((path, w, h) + size))
+        size = (w, h)
+        frames.append(to_pages(w, h, rows, int(args.invert)))
+    if args.x + w > 128 or args.page * 8 + h > 64:
+        sys.exit('%dx%d at (%d, page %d) is outside the screen' % (w, h, args.x, args.page))
+    delay = (args.delay + ANIM_DELAY_UNIT // 2) // ANIM_DELAY_UNIT
+    if not 0 <= delay < 256:
+        sys.exit('--delay must be less than %d ms' % (256 * ANIM_DELAY_UNIT))
+
+    name = args.name or re.sub(r'\W', '_', os.path.splitext(os.path.basename(args.input[0]))[0])
+    data, records = encode(frames, w, h, args.x, args.page, delay, args.loop, args.gap)
+    raw_size = write_header(args.output, name, data, w, h, len(frames), args.input[0])
+    sent = sum(len(r) - 2 for r in records)
+    sys.stderr.write('%s: %d frames of %dx%d, %d bytes of flash (raw %d), '
+                     'about %d bytes sent per frame\n' %
+                     (args.output, len(frames), w, h, len(data), raw_size,
+                      sent // max(len(records), 1)))
+
+
+if __name__ == '__main__':
+    main()
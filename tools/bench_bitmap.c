@@ -0,0 +1,112 @@
+/*
+ * bench_bitmap.c - Horizontal bitmap drawing speed (host benchmark)
+ * Oled Graphics library
+ *
+ * Compares Oled_DrawBitmapH (8x8 block transpose) with the former code,
+ * which sent every image byte to Oled_Draw8Pixel (one pixel at a time), on
+ * a full screen image. Both must give the same screen buffer, which is
+ * checked first on many sizes and positions.
+ *
+ * Build and run from the repository root:
+ * 	gcc -O2 -Itools/host/inc tools/bench_bitmap.c -o bench_bitmap && ./bench_bitmap
+ *
+ * Author: QUANG
+ */
+
+#include "../Oled.c"
+#include "../utility/Oled_bitmap.c"
+#include "host/bench.h"
+
+#define BENCH_LOOPS		20000
+
+/******************************************************************************
+ * bench_old_bitmapH - the former Oled_DrawBitmapH
+ *
+ * Parameter:
+ * 	(x, y): upper left position
+ * 	w	  : bitmap width
+ * 	h	  : bitmap height
+ * 	bitmap: horizontal bitmap (rows of bytes, MSB on the left)
+ *
+ * Return: none
+ *****************************************************************************/
+static void bench_old_bitmapH(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t *bitmap)
+{
+	uint8_t tmp, tmp_x, tmp_pxl;
+
+	if (x + w > OLED_COLUMNSIZE || y + h > OLED_HEIGHT)
+		return;
+	while (h--)
+	{
+		tmp = w;
+		tmp_x = x;
+		while (tmp)
+		{
+			tmp_pxl = (tmp >= 8) ? 8 : tmp;
+			Oled_Draw8Pixel(tmp_x, y, *(bitmap++), tmp_pxl, HORIZONTAL);
+			tmp -= tmp_pxl;
+			tmp_x += tmp_pxl;
+		}
+		y++;
+	}
+}
+
+/******************************************************************************
+ * bench_time - time of one full screen drawing
+ *
+ * Parameter:
+ * 	draw  : drawing function
+ * 	y	  : first row of the image
+ * 	bitmap: horizontal bitmap, 128 pixels wide
+ *
+ * Return: time in microseconds
+ *****************************************************************************/
+static double bench_time(void (*draw)(uint8_t, uint8_t, uint8_t, uint8_t, const uint8_t *),
+						 uint8_t y, const uint8_t *bitmap)
+{
+	double t;
+	long i;
+
+	t = bench_now();
+	for (i = 0; i < BENCH_LOOPS; i++)
+		draw(0, y, OLED_COLUMNSIZE, OLED_HEIGHT - y, bitmap);
+	return (bench_now() - t) / BENCH_LOOPS * 1e6;
+}
+
+int main(void)
+{
+	static uint8_t image[OLED_COLUMNSIZE / 8 * OLED_HEIGHT];
+	static uint8_t expected[OLED_COLUMNSIZE][OLED_PAGESIZE];
+	double before, after;
+	unsigned i, x, y, w, h, bad = 0, cases = 0;
+
+	srand(1);
+	for (i = 0; i < sizeof(image); i++)
+		image[i] = rand();
+
+	for (w = 1; w <= 40; w += 3)
+		for (h = 1; h <= 30; h += 4)
+			for (y = 0; y + h <= OLED_HEIGHT; y += 5)
+				for (x = 0; x + w <= OLED_COLUMNSIZE; x += 29)
+				{
+					memset(Oled_buff, 0x5A, sizeof(Oled_buff));
+					bench_old_bitmapH(x, y, w, h, image);
+					memcpy(expected, Oled_buff, sizeof(Oled_buff));
+					memset(Oled_buff, 0x5A, sizeof(Oled_buff));
+					Oled_DrawBitmapH(x, y, w, h, image);
+					bad += memcmp(expected, Oled_buff, sizeof(Oled_buff)) != 0;
+					cases++;
+				}
+	printf("%u cases, %u different from the former code\n", cases, bad);
+
+	for (y = 0; y <= 3; y += 3)
+	{
+		before = bench_time(bench_old_bitmapH, y, image);
+		after = bench_time(Oled_DrawBitmapH, y, image);
+		printf("128x%d at y=%u: %.2f us -> %.2f us (%.1fx)\n",
+			   OLED_HEIGHT - y, y, before, after, before / after);
+	}
+	return bad != 0;
+}
+
+/* End of bench_bitmap.c */
@@ -0,0 +1,193 @@
+/*
+ * bench_font.c - Raw and RLE font formats: size and rendering speed (host
+ * benchmark)
+ * Oled Graphics library
+ *
+ * Builds 2 fonts in both formats: the default 5x8 font and a 10x16 font (the
+ * default font scaled 2x, like a large font with blank pages and thick
+ * stems). Each RLE glyph is encoded by bench_rle_encode (host/rle.h) like
+ * fontconv.py does. For each font the glyph data size of both formats is
+ * printed with the characters per second of Oled_Putstring on a
+ * page-aligned row and on an unaligned row. Both formats must draw the same
+ * screen buffer, which is checked first at every row and at columns clipped
+ * by the right edge.
+ *
+ * Build and run from the repository root:
+ * 	gcc -O2 -Itools/host/inc tools/bench_font.c -o bench_font && ./bench_font
+ *
+ * Author: QUANG
+ */
+
+#include "../Oled.c"
+#include "host/bench.h"
+#include "host/rle.h"
+
+#define BENCH_TEXT		"The quick brown fox"
+#define BENCH_LOOPS		200000
+#define BENCH_GLYPHS	96			//' ' to 0x7F
+#define BENCH_MAX_GLYPH	(10 * 2)	//bytes of the largest raw glyph
+#define BENCH_CHUNK		8			//glyphs drawn at once by bench_check
+
+// Glyph descriptors and data of the test fonts, filled by bench_make_font
+static FONT_CHAR_INFO bench_info[4][BENCH_GLYPHS];
+static uint8_t bench_data[4][BENCH_GLYPHS * (BENCH_MAX_GLYPH + 1)];
+static unsigned bench_size[4];		//glyph data bytes
+
+static FONT_INFO bench_font[4] = {
+	{8, ' ', 0x7F, bench_info[0], bench_data[0], FONT_FORMAT_RAW, 0, 0, 0, 0},
+	{8, ' ', 0x7F, bench_info[1], bench_data[1], FONT_FORMAT_RLE, 0, 0, 0, 0},
+	{16, ' ', 0x7F, bench_info[2], bench_data[2], FONT_FORMAT_RAW, 0, 0, 0, 0},
+	{16, ' ', 0x7F, bench_info[3], bench_data[3], FONT_FORMAT_RLE, 0, 0, 0, 0},
+};
+
+/******************************************************************************
+ * bench_glyph - raw bytes of a glyph of a test font
+ * The bytes are page rows of w bytes, like the raw font data.
+ *
+ * Parameter:
+ * 	c	 : glyph index
+ * 	scale: 1: default font, 2: default font scaled 2x
+ * 	out	 : raw glyph bytes
+ *
+ * Return: glyph width
+ *****************************************************************************/
+static uint8_t bench_glyph(uint8_t c, uint8_t scale, uint8_t *out)
+{
+	const uint8_t *src = &ASCII[ASCIIDescriptors[c].offset];
+	uint8_t w = ASCIIDescriptors[c].widthBits;
+	uint16_t column;
+	uint8_t i, bit;
+
+	for (i = 0; i < w * scale; i++)
+	{
+		column = 0;
+		for (bit = 0; bit < 8 * scale; bit++)
+			column |= ((src[i / scale] >> (bit / scale)) & 1) << bit;
+		out[i] = column;
+		if (scale > 1)
+			out[w * scale + i] = column >> 8;
+	}
+	return w * scale;
+}
+
+/******************************************************************************
+ * bench_make_font - fill the descriptors and the data of a test font
+ *
+ * Parameter:
+ * 	n	 : test font (bench_font index)
+ * 	scale: 1: default font, 2: default font scaled 2x
+ *
+ * Return: none
+ *****************************************************************************/
+static void bench_make_font(uint8_t n, uint8_t scale)
+{
+	uint8_t glyph[BENCH_MAX_GLYPH];
+	unsigned size = 0, bytes;
+	uint8_t c, w;
+
+	for (c = 0; c < BENCH_GLYPHS; c++)
+	{
+		w = bench_glyph(c, scale, glyph);
+		bytes = w * scale;
+		memcpy(&bench_info[n][c], &(FONT_CHAR_INFO){w, size}, sizeof(FONT_CHAR_INFO));
+
+		if (bench_font[n].format == FONT_FORMAT_RLE)
+			size += bench_rle_encode(glyph, bytes, &bench_data[n][size]);
+		else
+		{
+			memcpy(&bench_data[n][size], glyph, bytes);
+			size += bytes;
+		}
+	}
+	bench_size[n] = size;
+}
+
+/******************************************************************************
+ * bench_check - compare the text drawn with 2 fonts
+ *
+ * Parameter:
+ * 	raw: font in the raw format
+ * 	rle: same font in the RLE format
+ *
+ * Return: number of different cases
+ *****************************************************************************/
+static unsigned bench_check(FONT_INFO *raw, FONT_INFO *rle)
+{
+	static uint8_t expected[OLED_COLUMNSIZE][OLED_PAGESIZE];
+	char text[BENCH_CHUNK];
+	unsigned bad = 0;
+	uint8_t x, y, c, first;
+
+	//every glyph, BENCH_CHUNK at a time so that the text stays in the x range
+	for (first = 0; first < BENCH_GLYPHS; first += BENCH_CHUNK)
+	{
+		for (c = 0; c < BENCH_CHUNK; c++)
+			text[c] = ' ' + first + c;
+
+		for (y = 0; y < OLED_HEIGHT; y++)
+			for (x = 0; x < OLED_COLUMNSIZE; x += 37)
+			{
+				memset(Oled_buff, 0x5A, sizeof(Oled_buff));
+				Oled_SetFont(raw);
+				currentX = x;
+				currentY = y;
+				Oled_Putstring(text, BENCH_CHUNK);
+				memcpy(expected, Oled_buff, sizeof(Oled_buff));
+
+				memset(Oled_buff, 0x5A, sizeof(Oled_buff));
+				Oled_SetFont(rle);
+				currentX = x;
+				currentY = y;
+				Oled_Putstring(text, BENCH_CHUNK);
+				bad += memcmp(expected, Oled_buff, sizeof(Oled_buff)) != 0;
+			}
+	}
+	return bad;
+}
+
+/******************************************************************************
+ * bench_text - characters per second of a font
+ *
+ * Parameter:
+ * 	font: the font
+ * 	y	: row of the text
+ *
+ * Return: characters per second
+ *****************************************************************************/
+static double bench_text(FONT_INFO *font, uint8_t y)
+{
+	double t;
+	long i;
+
+	Oled_SetFont(font);
+	t = bench_now();
+	for (i = 0; i < BENCH_LOOPS; i++)
+	{
+		currentX = 0;
+		currentY = y;
+		Oled_Putstring(BENCH_TEXT, sizeof(BENCH_TEXT) - 1);
+	}
+	t = bench_now() - t;
+	return BENCH_LOOPS * (sizeof(BENCH_TEXT) - 1) / t;
+}
+
+int main(void)
+{
+	static const char *name[4] = {"5x8    raw", "5x8    rle", "10x16  raw", "10x16  rle"};
+	unsigned bad = 0;
+	uint8_t n;
+
+	for (n = 0; n < 4; n++)
+		bench_make_font(n, (n < 2) ? 1 : 2);
+	bad += bench_check(&bench_font[0], &bench_font[1]);
+	bad += bench_check(&bench_font[2], &bench_font[3]);
+
+	printf("font   format  glyph data  aligned (y=8)   unaligned (y=3)\n");
+	for (n = 0; n < 4; n++)
+		printf("%s  %6u B    %6.1f Mchar/s  %6.1f Mchar/s\n", name[n], bench_size[n],
+			   bench_text(&bench_font[n], 8) / 1e6, bench_text(&bench_font[n], 3) / 1e6);
+	printf("%u cases different between the raw and the RLE fonts\n", bad);
+	return bad != 0;
+}
+
+/* End of bench_font.c */
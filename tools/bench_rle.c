@@ -0,0 +1,158 @@
+/*
+ * bench_rle.c - Run-length encoded bitmap decoding speed (host benchmark)
+ * Oled Graphics library
+ *
+ * Times Oled_DrawBitmapRLE against the raw image drawn by Oled_DrawBitmap
+ * and Oled_DrawBitmapRop, on 2 full screen images made here: a drawing
+ * (frame, disc, stripes, dithered band: what imgconv.py is meant for) and
+ * noise (nothing to compress). The images are encoded by bench_rle_encode
+ * (host/rle.h) like imgconv.py does. The decoded image must give the same
+ * screen buffer as Oled_DrawBitmapRop on the raw image, which is checked
+ * first at many positions (clipped on every edge) and raster operations.
+ *
+ * Build and run from the repository root:
+ * 	gcc -O2 -Itools/host/inc tools/bench_rle.c -o bench_rle && ./bench_rle
+ *
+ * Author: QUANG
+ */
+
+#include "../Oled.c"
+#include "../utility/Oled_bitmap.c"
+#include "host/bench.h"
+#include "host/rle.h"
+
+#define BENCH_LOOPS		20000
+#define BENCH_RAW_SIZE	(OLED_COLUMNSIZE * OLED_PAGESIZE)
+
+/******************************************************************************
+ * bench_pixel - set a pixel of a raw image (Oled_DrawBitmap layout)
+ *
+ * Parameter:
+ * 	image: 128x64 image
+ * 	(x, y): pixel
+ *
+ * Return: none
+ *****************************************************************************/
+static void bench_pixel(uint8_t *image, int x, int y)
+{
+	image[(y / 8) * OLED_COLUMNSIZE + x] |= 1 << (y % 8);
+}
+
+/******************************************************************************
+ * bench_drawing - a full screen drawing
+ *
+ * Parameter:
+ * 	image: 128x64 image, cleared
+ *
+ * Return: none
+ *****************************************************************************/
+static void bench_drawing(uint8_t *image)
+{
+	int x, y;
+
+	for (y = 0; y < OLED_HEIGHT; y++)
+		for (x = 0; x < OLED_COLUMNSIZE; x++)
+		{
+			if (x < 2 || x >= OLED_COLUMNSIZE - 2 || y < 2 || y >= OLED_HEIGHT - 2)
+				bench_pixel(image, x, y);									//frame
+			else if ((x - 40) * (x - 40) + (y - 32) * (y - 32) <= 22 * 22)
+				bench_pixel(image, x, y);									//disc
+			else if (x >= 72 && x < 120 && y >= 8 && y < 40 && y % 6 < 2)
+				bench_pixel(image, x, y);									//stripes
+			else if (x >= 72 && x < 120 && y >= 44 && y < 56 && (x + y) % 2)
+				bench_pixel(image, x, y);									//dithering
+		}
+}
+
+/******************************************************************************
+ * bench_check - compare Oled_DrawBitmapRLE with Oled_DrawBitmapRop
+ *
+ * Parameter:
+ * 	image: encoded image
+ * 	raw	 : the same image, not encoded
+ *
+ * Return: number of different cases
+ *****************************************************************************/
+static unsigned bench_check(const uint8_t *image, const uint8_t *raw)
+{
+	static uint8_t expected[OLED_COLUMNSIZE][OLED_PAGESIZE];
+	int x, y;
+	uint8_t rop;
+	unsigned bad = 0;
+
+	for (rop = BITMAP_ROP_COPY; rop <= BITMAP_ROP_INVERT; rop++)
+		for (y = -OLED_HEIGHT; y <= OLED_HEIGHT; y += 3)
+			for (x = -OLED_COLUMNSIZE; x <= OLED_COLUMNSIZE; x += 17)
+			{
+				memset(Oled_buff, 0x5A, sizeof(Oled_buff));
+				Oled_DrawBitmapRop(x, y, OLED_COLUMNSIZE, OLED_HEIGHT, raw, 0, rop);
+				memcpy(expected, Oled_buff, sizeof(Oled_buff));
+				memset(Oled_buff, 0x5A, sizeof(Oled_buff));
+				Oled_DrawBitmapRLE(x, y, image, rop);
+				bad += memcmp(expected, Oled_buff, sizeof(Oled_buff)) != 0;
+			}
+	return bad;
+}
+
+/******************************************************************************
+ * bench_time - time of one full screen drawing of an image
+ *
+ * Parameter:
+ * 	image: encoded image
+ * 	raw	 : the same image, not encoded
+ * 	y	 : first row of the image (0: aligned on a page)
+ *
+ * Return: none, the times are printed
+ *****************************************************************************/
+static void bench_time(const uint8_t *image, const uint8_t *raw, uint8_t y)
+{
+	double t, rle, bitmap, rop;
+	long i;
+
+	t = bench_now();
+	for (i = 0; i < BENCH_LOOPS; i++)
+		Oled_DrawBitmapRLE(0, y, image, BITMAP_ROP_COPY);
+	rle = (bench_now() - t) / BENCH_LOOPS * 1e6;
+
+	t = bench_now();
+	for (i = 0; i < BENCH_LOOPS; i++)
+		Oled_DrawBitmap(0, y, OLED_COLUMNSIZE, OLED_HEIGHT - y, raw);
+	bitmap = (bench_now() - t) / BENCH_LOOPS * 1e6;
+
+	t = bench_now();
+	for (i = 0; i < BENCH_LOOPS; i++)
+		Oled_DrawBitmapRop(0, y, OLED_COLUMNSIZE, OLED_HEIGHT, raw, 0, BITMAP_ROP_COPY);
+	rop = (bench_now() - t) / BENCH_LOOPS * 1e6;
+
+	printf("  y=%u: DrawBitmapRLE %.2f us, DrawBitmap %.2f us, DrawBitmapRop %.2f us\n",
+		   y, rle, bitmap, rop);
+}
+
+int main(void)
+{
+	static uint8_t raw[2][BENCH_RAW_SIZE];
+	static uint8_t image[2][2 + BENCH_RAW_SIZE + BENCH_RAW_SIZE / 128 + 1];
+	static const char *name[2] = {"drawing", "noise"};
+	unsigned i, size, bad = 0;
+
+	bench_drawing(raw[0]);
+	srand(1);
+	for (i = 0; i < BENCH_RAW_SIZE; i++)
+		raw[1][i] = rand();
+
+	for (i = 0; i < 2; i++)
+	{
+		image[i][0] = OLED_COLUMNSIZE;
+		image[i][1] = OLED_HEIGHT;
+		size = 2 + bench_rle_encode(raw[i], BENCH_RAW_SIZE, &image[i][2]);
+		bad += bench_check(image[i], raw[i]);
+
+		printf("%s: %u bytes (raw %u)\n", name[i], size, BENCH_RAW_SIZE);
+		bench_time(image[i], raw[i], 0);
+		bench_time(image[i], raw[i], 3);
+	}
+	printf("%u cases different from Oled_DrawBitmapRop\n", bad);
+	return bad != 0;
+}
+
+/* End of bench_rle.c */
@@ -0,0 +1,72 @@
+/*
+ * bench_text.c - Text rendering throughput (host benchmark)
+ * Oled Graphics library
+ *
+ * Prints characters per second of Oled_Putstring for the default 5x8 font
+ * and a 10x16 font, on a page-aligned row (plain byte copy) and on an
+ * unaligned row (every byte shifted across 2 pages).
+ *
+ * Build and run from the repository root:
+ * 	gcc -O2 -Itools/host/inc tools/bench_text.c -o bench_text && ./bench_text
+ *
+ * Author: QUANG
+ */
+
+#include "../Oled.c"
+#include "host/bench.h"
+
+#define BENCH_TEXT		"ABCDEFGHIJ"
+#define BENCH_LOOPS		300000
+
+// 10x16 test font: 96 glyphs of 10 columns x 2 pages
+#define G(i)			{10, (i) * 20}
+#define G4(i)			G(i), G(i + 1), G(i + 2), G(i + 3)
+#define G16(i)			G4(i), G4(i + 4), G4(i + 8), G4(i + 12)
+
+static const FONT_CHAR_INFO bench_info16[96] = {
+	G16(0), G16(16), G16(32), G16(48), G16(64), G16(80)
+};
+static uint8_t bench_data16[96 * 20];
+static FONT_INFO bench_font16 = {16, ' ', 0x7F, bench_info16, bench_data16,
+								 FONT_FORMAT_RAW, 0, 0, 0, 0};
+
+/******************************************************************************
+ * bench_text - characters per second of the current font
+ *
+ * Parameter:
+ * 	y: row of the text
+ *
+ * Return: characters per second
+ *****************************************************************************/
+static double bench_text(uint8_t y)
+{
+	double t;
+	long i;
+
+	t = bench_now();
+	for (i = 0; i < BENCH_LOOPS; i++)
+	{
+		currentX = 0;
+		currentY = y;
+		Oled_Putstring(BENCH_TEXT, sizeof(BENCH_TEXT) - 1);
+	}
+	t = bench_now() - t;
+	return BENCH_LOOPS * (sizeof(BENCH_TEXT) - 1) / t;
+}
+
+int main(void)
+{
+	unsigned i;
+
+	for (i = 0; i < sizeof(bench_data16); i++)
+		bench_data16[i] = i * 7;
+
+	printf("font   aligned (y=8)   unaligned (y=3)\n");
+	Oled_SetFont((FONT_INFO *)&fi_default);
+	printf("5x8    %6.1f Mchar/s  %6.1f Mchar/s\n", bench_text(8) / 1e6, bench_text(3) / 1e6);
+	Oled_SetFont(&bench_font16);
+	printf("10x16  %6.1f Mchar/s  %6.1f Mchar/s\n", bench_text(8) / 1e6, bench_text(3) / 1e6);
+	return 0;
+}
+
+/* End of bench_text.c */
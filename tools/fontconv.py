@@ -0,0 +1,452 @@
+#!/usr/bin/env python3
+"""
+fontconv.py - font compiler for the Oled Graphics library (host tool)
+
+Converts a font to a header for the library (see FONT_INFO in bitmap_db.h).
+
+Input:
+    - a BDF font (.bdf)
+    - a font header written for the library (a FONT_INFO, its FONT_CHAR_INFO
+      descriptors and its bitmap array, e.g. as generated by LCD Dot Factory)
+
+Output options:
+    --format raw|rle    glyph data stored as is or run-length encoded
+    --mono              monospace font without descriptors (raw format only)
+    --yshift N          glyphs pre-shifted N rows down (0 to 7), so text
+                        printed at y = 8*k + N is copied without shifting
+    --chars, --range,   keep only the listed characters; --scan collects the
+    --scan              characters of the string literals of C source files,
+                        so the font only holds what the application prints
+
+Characters outside 0x20-0xFF or with gaps between them are written as a
+sparse font (FONT_RANGE table).
+
+Usage:
+    fontconv.py input.bdf -o output.h [--name NAME] [--format rle]
+                [--mono] [--yshift N] [--scan src/*.c] [--chars "0123456789"]
+
+Author: QUANG
+"""
+
+import argparse
+import re
+import sys
+
+
+# ---------------------------------------------------------------------------
+# Font model
+# ---------------------------------------------------------------------------
+class Glyph(object):
+    def __init__(self, code, width, data):
+        self.code = code        # character code (Unicode code point)
+        self.width = width      # width in pixel
+        self.data = data        # raw bytes: page rows one after another
+
+
+class Font(object):
+    def __init__(self, height, glyphs):
+        self.height = height    # FONT_INFO.heightPages (height in pixel)
+        self.glyphs = glyphs    # list of Glyph, sorted by code
+
+    def pages(self):
+        return (self.height + 7) // 8
+
+
+def glyph_columns(glyph, pages):
+    """Return the glyph as one integer per column (bit n = row n)."""
+    cols = []
+    for i in range(glyph.width):
+        v = 0
+        for p in range(pages):
+            v |= glyph.data[p * glyph.width + i] << (8 * p)
+        cols.append(v)
+    return cols
+
+
+def columns_data(cols, pages):
+    """Inverse of glyph_columns."""
+    return [(c >> (8 * p)) & 0xFF for p in range(pages) for c in cols]
+
+
+# ---------------------------------------------------------------------------
+# Reading a font header
+# ---------------------------------------------------------------------------
+def _strip_comments(text):
+    token = re.compile(r'//[^\n]*|/\*.*?\*/|"(?:\\.|[^"\\])*"|\'(?:\\.|[^\'\\])*\'',
+                       re.S)
+    return token.sub(lambda m: ' ' if m.group(0)[0] == '/' else m.group(0), text)
+
+
+def _number(token):
+    token = token.strip()
+    m = re.match(r"^'(\\?.)'$", token)
+    if m:
+        c = m.group(1)
+        return ord({'\\\\': '\\', "\\'": "'"}.get(c, c[-1]))
+    return int(token.rstrip('uUlL'), 0)
+
+
+def _fields(body):
+    return re.findall(r"'(?:\\.|[^'])'|[^,\s][^,]*", body)
+
+
+def read_header(path, font_name=None):
+    text = _strip_comments(open(path, encoding='latin-1').read())
+
+    infos = re.findall(r'FONT_INFO\s+(\w+)\s*=\s*\{(.*?)\}\s*;', text, re.S)
+    if font_name:
+        infos = [i for i in infos if i[0] == font_name]
+    if not infos:
+        sys.exit('%s: no FONT_INFO found' % path)
+    name, body = infos[0]
+    fields = [f.strip() for f in _fields(body)]
+    height, start, end = _number(fields[0]), _number(fields[1]), _number(fields[2])
+    desc_name, data_name = fields[3].lstrip('&'), fields[4].lstrip('&')
+    extra = [f for f in fields[5:] if f not in ('0', 'FONT_FORMAT_RAW')]
+    if extra:
+        sys.exit('%s: %s is not a plain raw font' % (path, name))
+
+    m = re.search(r'FONT_CHAR_INFO\s+%s\s*\[\s*\]\s*=\s*\{(.*?)\}\s*;' % desc_name,
+                  text, re.S)
+    desc = [(_number(w), _number(o)) for w, o in
+            re.findall(r'\{\s*([^,{}]+?)\s*,\s*([^,{}]+?)\s*\}', m.group(1))]
+    m = re.search(r'%s\s*\[\s*\]\s*=\s*\{(.*?)\}\s*;' % data_name, text, re.S)
+    data = [_number(b) for b in _fields(m.group(1))]
+
+    # bytes per glyph column, from the distance between the glyph offsets
+    pages = (height + 7) // 8
+    offsets = sorted(set(o for w, o in desc) | set([len(data)]))
+    for (w, o) in desc:
+        nxt = offsets[offsets.index(o) + 1]
+        if w and (nxt - o) % w == 0 and nxt - o >= w:
+            pages = (nxt - o) // w
+            break
+    if pages != (height + 7) // 8:
+        # heightPages given in pages rather than pixels
+        height = 8 * pages
+
+    glyphs = []
+    for i, (w, o) in enumerate(desc[:end - start + 1]):
+        glyphs.append(Glyph(start + i, w, data[o:o + w * pages]))
+    return re.sub(r'FontInfo$', '', name), Font(height, glyphs)
+
+
+# ---------------------------------------------------------------------------
+# Reading a BDF font
+# ---------------------------------------------------------------------------
+def read_bdf(path):
+    ascent = descent = None
+    bbox = None
+    chars = []
+    cur = None
+    rows = None
+    for line in open(path, encoding='latin-1'):
+        words = line.split()
+        if not words:
+            continue
+        key = words[0]
+        if rows is not None:
+            if key == 'ENDCHAR':
+                cur['rows'] = rows
+                chars.append(cur)
+                cur = rows = None
+            else:
+                rows.append(int(key, 16))
+        elif key == 'FONTBOUNDINGBOX':
+            bbox = [int(v) for v in words[1:5]]
+        elif key == 'FONT_ASCENT':
+            ascent = int(words[1])
+        elif key == 'FONT_DESCENT':
+            descent = int(words[1])
+        elif key == 'STARTCHAR':
+            cur = {'code': -1, 'dwidth': None, 'bbx': None}
+        elif key == 'ENCODING' and cur is not None:
+            cur['code'] = int(words[-1])
+        elif key == 'DWIDTH' and cur is not None:
+            cur['dwidth'] = int(words[1])
+        elif key == 'BBX' and cur is not None:
+            cur['bbx'] = [int(v) for v in words[1:5]]
+        elif key == 'BITMAP' and cur is not None:
+            rows = []
+
+    if ascent is None:
+        ascent = bbox[1] + bbox[3]
+    if descent is None:
+        descent = -bbox[3]
+    height = ascent + descent
+    pages = (height + 7) // 8
+
+    glyphs = {}
+    for c in chars:
+        if c['code'] < 0 or c['code'] > 0xFFFF:
+            continue
+        bw, bh, bx, by = c['bbx'] or bbox
+        dwidth = c['dwidth'] if c['dwidth'] is not None else bw + max(bx, 0) + 1
+        # the library adds a 1-pixel-wide space before each glyph
+        width = max(1, dwidth - 1, bx + bw)
+        cols = [0] * width
+        nbits = ((bw + 7) // 8) * 8
+        top = ascent - (by + bh)
+        for r, bits in enumerate(c['rows'][:bh]):
+            y = top + r
+            if y < 0 or y >= height:
+                continue
+            for col in range(bw):
+                x = bx + col
+                if 0 <= x < width and (bits >> (nbits - 1 - col)) & 1:
+                    cols[x] |= 1 << y
+        glyphs[c['code']] = Glyph(c['code'], width, columns_data(cols, pages))
+    return re.sub(r'\W', '_', path.split('/')[-1].rsplit('.', 1)[0]), \
+        Font(height, [glyphs[k] for k in sorted(glyphs)])
+
+
+# ---------------------------------------------------------------------------
+# Subsetting
+# ---------------------------------------------------------------------------
+def _c_string(body):
+    """Decode the body of a C string literal to text (UTF-8 source)."""
+    out = bytearray()
+    i = 0
+    raw = body.encode('utf-8', 'surrogateescape')
+    while i < len(raw):
+        c = raw[i]
+        if c != 0x5C:                       # not a backslash
+            out.append(c)
+            i += 1
+            continue
+        nxt = chr(raw[i + 1])
+        if nxt == 'x':
+            m = re.match(rb'[0-9a-fA-F]+', raw[i + 2:])
+            out.append(int(m.group(0), 16) & 0xFF)
+            i += 2 + len(m.group(0))
+        elif nxt in '01234567':
+            m = re.match(rb'[0-7]{1,3}', raw[i + 1:])
+            out.append(int(m.group(0), 8) & 0xFF)
+            i += 1 + len(m.group(0))
+        else:
+            out.extend({'n': b'\n', 't': b'\t', 'r': b'\r', '0': b'\0'}
+                       .get(nxt, nxt.encode()))
+            i += 2
+    return out.decode('utf-8', 'replace')
+
+
+def scan_sources(paths):
+    """Characters used by the string literals of C source files."""
+    codes = set()
+    literal = re.compile(r'"((?:\\.|[^"\\\n])*)"')
+    spec = re.compile(r'%[-+ 0#]*\d*(?:\.\d+)?l?[a-zA-Z%]')
+    for path in paths:
+        text = open(path, encoding='utf-8', errors='surrogateescape').read()
+        text = re.sub(r'//[^\n]*|/\*.*?\*/', ' ', text, flags=re.S)
+        for body in literal.findall(text):
+            for c in spec.sub('', _c_string(body)):
+                if ord(c) >= 0x20 and ord(c) <= 0xFFFF:
+                    codes.add(ord(c))
+    return codes
+
+
+def parse_ranges(text):
+    codes = set()
+    for part in text.split(','):
+        a, _, b = part.partition('-')
+        codes.update(range(int(a, 0), int(b or a, 0) + 1))
+    return codes
+
+
+def subset(font, codes):
+    glyphs = [g for g in font.glyphs if g.code in codes]
+    missing = sorted(codes - set(g.code for g in glyphs))
+    if missing:
+        sys.stderr.write('warning: not in the font: %s\n' %
+                         ' '.join('U+%04X' % c for c in missing))
+    return Font(font.height, glyphs)
+
+
+# ---------------------------------------------------------------------------
+# Encoding
+# ---------------------------------------------------------------------------
+def rle_encode(data):
+    """Encode bytes with the FONT_FORMAT_RLE packets."""
+    out, lit, i, n = [], [], 0, len(data)
+
+    def flush():
+        while lit:
+            chunk = lit[:128]
+            del lit[:128]
+            out.extend([len(chunk) - 1] + chunk)
+
+    while i < n:
+        run = 1
+        while i + run < n and data[i + run] == data[i]:
+            run += 1
+        if data[i] == 0 and run >= 2:
+            flush()
+            run = min(run, 64)
+            out.append(0x80 | (run - 1))
+        elif run >= 3:
+            flush()
+            run = min(run, 65)
+            out.extend([0xC0 | (run - 2), data[i]])
+        else:
+            run = 1
+            lit.append(data[i])
+        i += run
+    flush()
+    return out
+
+
+def transform(font, mono, yshift):
+    """Pad to a fixed width and pre-shift the glyphs."""
+    pages = font.pages()
+    out_pages = (font.height + yshift + 7) // 8
+    width = max(g.width for g in font.glyphs) if mono else None
+    glyphs = []
+    for g in font.glyphs:
+        cols = [c << yshift for c in glyph_columns(g, pages)]
+        if mono:
+            cols += [0] * (width - len(cols))
+        glyphs.append(Glyph(g.code, len(cols), columns_data(cols, out_pages)))
+    return glyphs, width or 0
+
+
+def code_ranges(codes):
+    """Split sorted codes into runs of consecutive codes: (first, last, index)."""
+    ranges = []
+    for i, c in enumerate(codes):
+        if ranges and c == ranges[-1][1] + 1:
+            ranges[-1][1] = c
+        else:
+            ranges.append([c, c, i])
+    return ranges
+
+
+# ---------------------------------------------------------------------------
+# Writing a font header
+# ---------------------------------------------------------------------------
+def _char_comment(code):
+    c = chr(code)
+    if code < 0x20 or code > 0x7E or c in '\\*/':
+        return 'U+%04X' % code
+    return c
+
+
+def _hex_lines(data, indent='\t'):
+    lines = []
+    for i in range(0, len(data), 12):
+        lines.append(indent + ', '.join('0x%02X' % b for b in data[i:i + 12]) + ',')
+    return lines
+
+
+def write_header(path, name, font, fmt, mono, yshift, source):
+    if not font.glyphs:
+        sys.exit('no character left in the font')
+    if mono and fmt != 'raw':
+        sys.exit('--mono needs the raw format (glyphs are found by their size)')
+    encode = rle_encode if fmt == 'rle' else list
+    glyphs, mono_width = transform(font, mono, yshift)
+    raw_size = sum(len(g.data) for g in font.glyphs)
+
+    data, desc = [], []
+    for g in glyphs:
+        desc.append((g.width, len(data), g.code))
+        data.extend(encode(g.data))
+    if len(data) > 0xFFFF:
+        sys.exit('font data too large for 16-bit offsets')
+
+    codes = [g.code for g in glyphs]
+    ranges = code_ranges(codes)
+    sparse = len(ranges) > 1 or codes[-1] > 0xFF
+    if sparse and len(ranges) > 255:
+        sys.exit('%d code ranges, FONT_INFO.rangeCount holds at most 255' % len(ranges))
+    start, end = (0, 0) if sparse else (codes[0], codes[-1])
+
+    desc_size = 0 if mono else 4 * len(desc)
+    range_size = 6 * len(ranges) if sparse else 0
+    guard = re.sub(r'\W', '_', name).upper() + '_H_'
+    out = []
+    out.append('/*')
+    out.append(' * %s - generated by tools/fontconv.py from %s' % (name, source))
+    out.append(' * Oled Graphics library')
+    out.append(' *')
+    out.append(' * Format: %s%s, %d characters, height %d pixels%s' %
+               (fmt.upper(), ' monospace' if mono else '', len(glyphs),
+                font.height, ', pre-shifted %d rows' % yshift if yshift else ''))
+    out.append(' * Flash: %d bytes (glyph data %d, raw %d; descriptors %d; ranges %d)' %
+               (len(data) + desc_size + range_size, len(data), raw_size,
+                desc_size, range_size))
+    out.append(' */')
+    out.append('')
+    out.append('#ifndef %s' % guard)
+    out.append('#define %s' % guard)
+    out.append('')
+    out.append('const uint8_t %sBitmaps[] = {' % name)
+    for n, (w, o, code) in enumerate(desc):
+        end_o = desc[n + 1][1] if n + 1 < len(desc) else len(data)
+        if end_o > o:
+            out.append('\t// %s' % _char_comment(code))
+            out.extend(_hex_lines(data[o:end_o]))
+    out.append('};')
+    out.append('')
+    if not mono:
+        out.append('const FONT_CHAR_INFO %sDescriptors[] = {' % name)
+        for w, o, code in desc:
+            out.append('\t{%d, %d},\t\t/* %s */' % (w, o, _char_comment(code)))
+        out.append('};')
+        out.append('')
+    if sparse:
+        out.append('const FONT_RANGE %sRanges[] = {' % name)
+        for first, last, index in ranges:
+            out.append('\t{0x%04X, 0x%04X, %d},' % (first, last, index))
+        out.append('};')
+        out.append('')
+    out.append('const FONT_INFO %sFontInfo = {%d, 0x%02X, 0x%02X, %s, %sBitmaps, '
+               'FONT_FORMAT_%s, %s, %d, %d, %d};' %
+               (name, font.height, start, end,
+                '0' if mono else name + 'Descriptors', name, fmt.upper(),
+                name + 'Ranges' if sparse else '0', len(ranges) if sparse else 0,
+                mono_width, yshift))
+    out.append('')
+    out.append('#endif /* %s */' % guard)
+    with open(path, 'w', newline='\r\n') as f:
+        f.write('\n'.join(out) + '\n')
+    return len(data) + desc_size + range_size
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    ap.add_argument('input', help='BDF font or font header (.h) with a FONT_INFO')
+    ap.add_argument('-o', '--output', required=True, help='output header')
+    ap.add_argument('--font', help='FONT_INFO to read if the header has several')
+    ap.add_argument('--name', help='prefix of the generated arrays')
+    ap.add_argument('--format', choices=('raw', 'rle'), default='raw')
+    ap.add_argument('--mono', action='store_true',
+                    help='monospace font without descriptors')
+    ap.add_argument('--yshift', type=int, default=0, choices=range(8),
+                    help='pre-shift the glyphs down by N rows')
+    ap.add_argument('--scan', nargs='+', default=[], metavar='FILE',
+                    help='keep the characters used in string literals of FILEs')
+    ap.add_argument('--chars', default='', help='characters to keep')
+    ap.add_argument('--range', default='', help='code points to keep, e.g. 0x30-0x39,0xB0')
+    args = ap.parse_args()
+
+    if args.input.lower().endswith('.bdf'):
+        name, font = read_bdf(args.input)
+    else:
+        name, font = read_header(args.input, args.font)
+    name = args.name or name
+
+    if args.scan or args.chars or args.range:
+        codes = set(ord(c) for c in args.chars)
+        if args.range:
+            codes |= parse_ranges(args.range)
+        codes |= scan_sources(args.scan)
+        font = subset(font, codes)
+
+    size = write_header(args.output, name, font, args.format, args.mono,
+                        args.yshift, args.input)
+    sys.stderr.write('%s: %d characters, %d bytes of flash\n' %
+                     (args.output, len(font.glyphs), size))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,39 @@
+/*
+ * bench.h - Timing helpers of the host benchmarks
+ * Oled Graphics library (host tools)
+ *
+ * A benchmark includes Oled.c (and the utility files it needs) then this
+ * file, so the static functions of the library can be called too. The SPI
+ * bytes are only counted.
+ *
+ * Author: QUANG
+ */
+
+#ifndef HOST_BENCH_H_
+#define HOST_BENCH_H_
+
+#include <stdio.h>
+#include <time.h>
+
+unsigned long bench_spi_bytes;			// bytes sent to the Oled
+
+void SPI_SendByte(uint8_t data)
+{
+	(void)data;
+	bench_spi_bytes++;
+}
+
+/******************************************************************************
+ * bench_now - monotonic time
+ *
+ * Return: time in seconds
+ *****************************************************************************/
+static double bench_now(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+#endif /* HOST_BENCH_H_ */
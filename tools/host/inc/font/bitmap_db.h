@@ -0,0 +1,6 @@
+/*
+ * bitmap_db.h - Host path of the font structures
+ * Oled Graphics library (host tools)
+ */
+
+#include "../../../../bitmap_db.h"
@@ -0,0 +1,11 @@
+/*
+ * font_include.h - Host replacement of the font list
+ * Oled Graphics library (host tools)
+ *
+ * The benchmarks use the default font and their own test fonts.
+ */
+
+#ifndef FONT_INCLUDE_H_
+#define FONT_INCLUDE_H_
+
+#endif /* FONT_INCLUDE_H_ */
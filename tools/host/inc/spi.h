@@ -0,0 +1,23 @@
+/*
+ * spi.h - Host replacement of the SPI driver
+ * Oled Graphics library (host tools)
+ *
+ * The chip select and data/command pins do nothing, SPI_SendByte is
+ * defined by tools/host/bench.h.
+ *
+ * Author: QUANG
+ */
+
+#ifndef HOST_SPI_H_
+#define HOST_SPI_H_
+
+#include <stdint.h>
+
+void SPI_SendByte(uint8_t data);
+
+#define SH1106_DC_LOW()
+#define SH1106_DC_HIGH()
+#define SH1106_CS_LOW()
+#define SH1106_CS_HIGH()
+
+#endif /* HOST_SPI_H_ */
@@ -0,0 +1,23 @@
+/*
+ * include.h - Host replacement of the project include file
+ * Oled Graphics library (host tools)
+ *
+ * Lets Oled.c and the utility files build on a PC for the benchmarks in
+ * tools/: the standard headers and the TivaWare functions used by Oled.c.
+ *
+ * Author: QUANG
+ */
+
+#ifndef HOST_INCLUDE_H_
+#define HOST_INCLUDE_H_
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+static inline void SysCtlDelay(unsigned long count) { (void)count; }
+static inline unsigned long ROM_SysCtlClockGet(void) { return 80000000; }
+
+#endif /* HOST_INCLUDE_H_ */
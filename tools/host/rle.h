@@ -0,0 +1,68 @@
+/*
+ * rle.h - Run-length encoder of the host benchmarks
+ * Oled Graphics library (host tools)
+ *
+ * Encodes bytes with the FONT_FORMAT_RLE packets, like rle_encode of
+ * tools/fontconv.py (fonts) and tools/imgconv.py (images), so a benchmark
+ * can build its compressed data itself.
+ *
+ * Author: QUANG
+ */
+
+#ifndef HOST_RLE_H_
+#define HOST_RLE_H_
+
+/******************************************************************************
+ * bench_rle_encode - encode bytes with the FONT_FORMAT_RLE packets
+ * Same packets as rle_encode of tools/fontconv.py.
+ *
+ * Parameter:
+ * 	data: bytes to encode
+ * 	n	: number of bytes
+ * 	out	: encoded bytes (at most n + n / 128 + 1 bytes)
+ *
+ * Return: number of encoded bytes
+ *****************************************************************************/
+static unsigned bench_rle_encode(const uint8_t *data, unsigned n, uint8_t *out)
+{
+	unsigned i = 0, run, size = 0, lit = 0;
+
+	while (i < n)
+	{
+		for (run = 1; i + run < n && data[i + run] == data[i]; run++)
+			;
+		if ((data[i] == 0 && run >= 2) || run >= 3)
+		{
+			if (lit)									//flush the literal bytes
+				out[size - lit - 1] = lit - 1;
+			lit = 0;
+			if (data[i] == 0)
+			{
+				run = (run > 64) ? 64 : run;
+				out[size++] = 0x80 | (run - 1);
+			}
+			else
+			{
+				run = (run > 65) ? 65 : run;
+				out[size++] = 0xC0 | (run - 2);
+				out[size++] = data[i];
+			}
+			i += run;
+			continue;
+		}
+		if (lit == 128)
+		{
+			out[size - lit - 1] = lit - 1;
+			lit = 0;
+		}
+		if (!lit)
+			size++;										//packet byte, set on flush
+		out[size++] = data[i++];
+		lit++;
+	}
+	if (lit)
+		out[size - lit - 1] = lit - 1;
+	return size;
+}
+
+#endif /* HOST_RLE_H_ */
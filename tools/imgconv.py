@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+"""
+imgconv.py - image compiler for the Oled Graphics library (host tool)
+
+Converts a monochrome image to a header for the library.
+
+Input:
+    - a PBM image (.pbm, plain P1 or raw P4), e.g. made with
+      "convert splash.png -monochrome splash.pbm"
+      (black pixels are the lit pixels, see --invert)
+
+Output options:
+    --format rle    width, height and the run-length encoded bytes, for
+                    Oled_DrawBitmapRLE and Oled_SendBitmapRLE (default, with
+                    a warning when it is not smaller than raw)
+    --format raw    the bytes as is, for Oled_DrawBitmap and Oled_DrawImage
+    --invert        white pixels are the lit pixels
+
+The bytes are vertical (LSB on top), page by page (Oled_DrawBitmap layout).
+The RLE packets are the FONT_FORMAT_RLE packets of fontconv.py.
+
+Usage:
+    imgconv.py splash.pbm -o splash.h [--name NAME] [--format raw] [--invert]
+
+Author: QUANG
+"""
+
+import argparse
+import os
+import re
+import sys
+
+from fontconv import rle_encode, _hex_lines
+
+
+# ---------------------------------------------------------------------------
+# Input
+# ---------------------------------------------------------------------------
+def _pbm_tokens(data):
+    """Header tokens of a PBM file and the offset of the pixel data."""
+    tokens, i = [], 0
+    while len(tokens) < 3:
+        while data[i:i + 1].isspace():
+            i += 1
+        if data[i:i + 1] == b'#':
+            while data[i:i + 1] not in (b'\n', b''):
+                i += 1
+            continue
+        j = i
+        while j < len(data) and not data[j:j + 1].isspace():
+            j += 1
+        tokens.append(data[i:j])
+        i = j
+    return tokens, i + 1
+
+
+def read_pbm(path):
+    """Return (width, height, rows), rows[y][x] is 1 for a black pixel."""
+    with open(path, 'rb') as f:
+        data = f.read()
+    (magic, w, h), offset = _pbm_tokens(data)
+    w, h = int(w), int(h)
+    if magic == b'P1':
+        bits = [int(c) for c in re.findall(rb'[01]', data[offset:])]
+        rows = [bits[y * w:(y + 1) * w] for y in range(h)]
+    elif magic == b'P4':
+        stride = (w + 7) // 8
+        rows = []
+        for y in range(h):
+            line = data[offset + y * stride:offset + (y + 1) * stride]
+            rows.append([(line[x // 8] >> (7 - x % 8)) & 1 for x in range(w)])
+    else:
+        sys.exit('%s: not a PBM image (P1 or P4)' % path)
+    if w > 255 or h > 255:
+        sys.exit('%s: %dx%d, the image must be at most 255x255' % (path, w, h))
+    return w, h, rows
+
+
+# ---------------------------------------------------------------------------
+# Encoding
+# ---------------------------------------------------------------------------
+def to_pages(w, h, rows, invert):
+    """Vertical bytes, page by page."""
+    out = []
+    for page in range((h + 7) // 8):
+        for x in range(w):
+            b = 0
+            for bit in range(8):
+                y = page * 8 + bit
+                if y < h and rows[y][x] ^ invert:
+                    b |= 1 << bit
+            out.append(b)
+    return out
+
+
+def write_header(path, name, w, h, data, fmt, source):
+    raw_size = len(data)
+    if fmt == 'rle':
+        data = [w, h] + rle_encode(data)
+    guard = re.sub(r'\W', '_', name).upper() + '_H_'
+    out = []
+    out.append('/*')
+    out.append(' * %s - generated by tools/imgconv.py from %s' % (name, source))
+    out.append(' * Oled Graphics library')
+    out.append(' *')
+    out.append(' * Format: %s bitmap, %dx%d pixels' % (fmt.upper(), w, h))
+    out.append(' * Flash: %d bytes (raw %d)' % (len(data), raw_size))
+    out.append(' */')
+    out.append('')
+    out.append('#ifndef %s' % guard)
+    out.append('#define %s' % guard)
+    out.append('')
+    out.append('const uint8_t %s[] = {' % name)
+    out.extend(_hex_lines(data))
+    out.append('};')
+    out.append('')
+    out.append('#endif /* %s */' % guard)
+    with open(path, 'w', newline='\r\n') as f:
+        f.write('\n'.join(out) + '\n')
+    return len(data), raw_size
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    ap.add_argument('input', help='PBM image')
+    ap.add_argument('-o', '--output', required=True, help='output header')
+    ap.add_argument('--name', help='name of the generated array')
+    ap.add_argument('--format', choices=('raw', 'rle'), default='rle')
+    ap.add_argument('--invert', action='store_true',
+                    help='white pixels are the lit pixels')
+    args = ap.parse_args()
+
+    w, h, rows = read_pbm(args.input)
+    name = args.name or re.sub(r'\W', '_', os.path.splitext(os.path.basename(args.input))[0])
+    data = to_pages(w, h, rows, int(args.invert))
+    size, raw_size = write_header(args.output, name, w, h, data, args.format, args.input)
+    sys.stderr.write('%s: %dx%d, %d bytes of flash (raw %d)\n' %
+                     (args.output, w, h, size, raw_size))
+    if args.format == 'rle' and size >= raw_size:
+        sys.stderr.write('warning: RLE does not save flash for %s (%d bytes, raw %d), '
+                         'use --format raw\n' % (args.input, size, raw_size))
+
+
+if __name__ == '__main__':
+    main()
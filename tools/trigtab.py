@@ -0,0 +1,63 @@
+#!/usr/bin/env python3
+"""
+trigtab.py - trigonometry table generator for the Oled Graphics library
+(host tool)
+
+Writes the Q15 tables used by utility/Oled_trig.c:
+    - sin(0..90 degrees), 1 degree steps
+    - tan(d + 0.5 degree) for d = 0..44, the rounding bounds of atan2
+
+Usage:
+    trigtab.py -o utility/Oled_trigtab.h
+
+Author: QUANG
+"""
+
+import argparse
+import math
+
+Q15 = 32768
+
+
+def q15(value):
+    return int(math.floor(value * Q15 + 0.5))
+
+
+def c_array(ctype, name, values, comment):
+    lines = ['// %s' % comment,
+             'static const %s %s[%d] = {' % (ctype, name, len(values))]
+    for i in range(0, len(values), 10):
+        lines.append('\t\t' + ', '.join('%d' % v for v in values[i:i + 10]) + ',')
+    lines[-1] = lines[-1].rstrip(',') + '};'
+    return lines
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    ap.add_argument('-o', '--output', required=True, help='output header')
+    args = ap.parse_args()
+
+    # sin(90) is clamped: 1.0 does not fit a Q15 int16_t
+    sine = [min(q15(math.sin(math.radians(d))), Q15 - 1) for d in range(91)]
+    bound = [q15(math.tan(math.radians(d + 0.5))) for d in range(45)]
+
+    lines = ['/*',
+             ' * Oled_trigtab.h - Q15 trigonometry tables',
+             ' * Generated by tools/trigtab.py, do not edit.',
+             ' */',
+             '',
+             '#ifndef OLED_TRIGTAB_H_',
+             '#define OLED_TRIGTAB_H_',
+             '']
+    lines += c_array('int16_t', 'g_pi16SinTable', sine, 'sin(0..90 degrees) in Q15')
+    lines.append('')
+    lines += c_array('uint16_t', 'g_pui16AtanBound', bound,
+                     'tan(d + 0.5 degree) in Q15: atan2 rounds to d + 1 from this bound')
+    lines += ['', '#endif /* OLED_TRIGTAB_H_ */', '']
+
+    with open(args.output, 'wb') as f:
+        f.write('\r\n'.join(lines).encode('ascii'))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,243 @@
+/*
+ * Oled_anim.c - Delta encoded animations played from flash
+ * Oled Graphics library
+ *
+ * An animation (made by tools/animconv.py) is a keyframe followed by frame
+ * records. A frame record only holds the page bytes that changed since the
+ * previous frame, as runs of XOR bytes, so the flash used grows with the
+ * motion and not with the number of frames. The player applies each record
+ * to the screen buffer and sends only its runs to the Oled, when the frame
+ * is due on the caller's millisecond timer.
+ *
+ * Data layout:
+ * 	- frame count (2 bytes, little endian), keyframe not included
+ * 	- x, page: upper left column and page of the animation
+ * 	- flags: ANIM_FLAG_LOOP, the last frame turns back to the keyframe
+ * 	- keyframe size (2 bytes, little endian)
+ * 	- keyframe: Oled_DrawBitmapRLE image (width, height, RLE packets)
+ * 	- frame records:
+ * 		- delay (units of ANIM_DELAY_UNIT ms) since the previous frame
+ * 		- runs: page, column (from x, page), length n, n XOR bytes
+ * 		- ANIM_END
+ *
+ * This library is use for Tiva Arm Cotex M4
+ * Device: OLED 1.3", 128x64 dot matrix panel
+ * Communication: SPI interface
+ * Driver: SH1106
+ *
+ * Revision: 2.02
+ * Author: QUANG
+ */
+
+#include "../Oled.h"
+
+#define ANIM_FRAMES		0		//offsets in the animation header
+#define ANIM_X			2
+#define ANIM_PAGE		3
+#define ANIM_FLAGS		4
+#define ANIM_KEYSIZE	5
+#define ANIM_HEADER		7
+
+#define ANIM_FLAG_LOOP	0x01	//the last frame turns back to the keyframe
+#define ANIM_END		0xFF	//end of a frame record
+#define ANIM_DELAY_UNIT	10		//ms
+
+/*************************Private function prototypes*************************/
+static const uint8_t *Oled_anim_first(const uint8_t *data);
+static const uint8_t *Oled_anim_apply(const uint8_t *data, const uint8_t *frame,
+									  uint8_t *lo, uint8_t *hi);
+static void Oled_anim_send(const uint8_t *data, const uint8_t *frame);
+
+/****************************Function definitions*****************************/
+
+/******************************************************************************
+ * Oled_AnimationStart - start playing an animation
+ * The keyframe is drawn into the screen buffer and sent to the Oled. The
+ * first frame is due after its delay. An animation of a single frame (the
+ * keyframe only) is drawn and does not play.
+ *
+ * Parameter:
+ * 	anim: animation player
+ * 	data: animation made by tools/animconv.py
+ * 	now	: current time of the caller's timer (ms)
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_AnimationStart(OLED_ANIMATION *anim, const uint8_t *data, uint32_t now)
+{
+	const uint8_t *key = &data[ANIM_HEADER];
+	uint8_t x = data[ANIM_X], y = data[ANIM_PAGE] * 8;
+	uint8_t w = key[0], h = key[1];
+
+	anim->data = data;
+	anim->next = Oled_anim_first(data);
+	anim->frame = 0;
+	anim->playing = (data[ANIM_FRAMES] | data[ANIM_FRAMES + 1]) != 0;
+	//a single frame animation has no frame record
+	anim->due = anim->playing ? now + anim->next[0] * ANIM_DELAY_UNIT : now;
+
+	//sanity check
+	if (x >= OLED_COLUMNSIZE || y >= OLED_HEIGHT)
+		return;
+	if (w > OLED_COLUMNSIZE - x)
+		w = OLED_COLUMNSIZE - x;
+	if (h > OLED_HEIGHT - y)
+		h = OLED_HEIGHT - y;
+
+	Oled_DrawBitmapRLE(x, y, key, BITMAP_ROP_COPY);
+	Oled_UpdateScreen(x, y, w, h);
+}
+
+/******************************************************************************
+ * Oled_AnimationUpdate - show the frames that are due
+ * Call it from the main loop or a timer tick. Each due frame is applied to
+ * the screen buffer. When only one frame is due, its runs are sent as they
+ * are; when the call is late and several frames are due, each page sends one
+ * span covering the runs of all of them. A looping animation starts again
+ * after its last frame (at most one pass per call).
+ *
+ * Parameter:
+ * 	anim: animation player (started by Oled_AnimationStart)
+ * 	now	: current time of the caller's timer (ms)
+ *
+ * Return: true while the animation plays, false once the last frame is shown
+ *****************************************************************************/
+bool Oled_AnimationUpdate(OLED_ANIMATION *anim, uint32_t now)
+{
+	const uint8_t *data = anim->data;
+	const uint8_t *frame = anim->next;
+	uint16_t frames = data[ANIM_FRAMES] | (data[ANIM_FRAMES + 1] << 8);
+	uint8_t lo[OLED_PAGESIZE], hi[OLED_PAGESIZE];
+	uint16_t n = 0;
+	uint8_t page;
+
+	if (!anim->playing)
+		return false;
+
+	for (page = 0; page < OLED_PAGESIZE; page++)
+	{
+		lo[page] = OLED_COLUMNSIZE;
+		hi[page] = 0;
+	}
+
+	while ((int32_t)(now - anim->due) >= 0 && n < frames)
+	{
+		anim->next = Oled_anim_apply(data, anim->next, lo, hi);
+		n++;
+		if (++anim->frame == frames)
+		{
+			if (!(data[ANIM_FLAGS] & ANIM_FLAG_LOOP))
+			{
+				anim->playing = false;
+				break;
+			}
+			anim->next = Oled_anim_first(data);
+			anim->frame = 0;
+		}
+		anim->due += anim->next[0] * ANIM_DELAY_UNIT;
+	}
+
+	if (n == 1)
+		Oled_anim_send(data, frame);
+	else if (n > 1)
+	{
+		for (page = 0; page < OLED_PAGESIZE; page++)
+		{
+			if (lo[page] < hi[page])
+				Oled_UpdateScreen(lo[page], page * 8, hi[page] - lo[page], 8);
+		}
+	}
+	return anim->playing;
+}
+
+/******************************************************************************
+ * Oled_anim_first - first frame record of an animation
+ * This function support the animation player
+ *
+ * Parameter:
+ * 	data: animation
+ *
+ * Return: the record following the keyframe
+ *****************************************************************************/
+static const uint8_t *Oled_anim_first(const uint8_t *data)
+{
+	return &data[ANIM_HEADER + (data[ANIM_KEYSIZE] | (data[ANIM_KEYSIZE + 1] << 8))];
+}
+
+/******************************************************************************
+ * Oled_anim_apply - apply a frame record to the screen buffer
+ * This function support the animation player (Oled_AnimationUpdate)
+ * Every run is XORed into the buffer (clipped to the screen) and widens the
+ * column span [lo, hi) of its page.
+ *
+ * Parameter:
+ * 	data : animation
+ * 	frame: frame record
+ * 	lo	 : first changed column of each page
+ * 	hi	 : column after the last changed column of each page
+ *
+ * Return: the next frame record
+ *****************************************************************************/
+static const uint8_t *Oled_anim_apply(const uint8_t *data, const uint8_t *frame,
+									  uint8_t *lo, uint8_t *hi)
+{
+	uint8_t *buffer = Oled_GetBuffer();
+	uint16_t x, end;
+	uint8_t page, n, i;
+
+	frame++;		//delay
+	while (*frame != ANIM_END)
+	{
+		page = data[ANIM_PAGE] + frame[0];
+		x = data[ANIM_X] + frame[1];
+		n = frame[2];
+		frame += 3;
+
+		end = (x + n > OLED_COLUMNSIZE) ? OLED_COLUMNSIZE : x + n;
+		if (page < OLED_PAGESIZE && x < end)
+		{
+			for (i = 0; x + i < end; i++)
+				buffer[(x + i) * OLED_PAGESIZE + page] ^= frame[i];
+			if (lo[page] > x)
+				lo[page] = x;
+			if (hi[page] < end)
+				hi[page] = end;
+		}
+		frame += n;
+	}
+	return frame + 1;
+}
+
+/******************************************************************************
+ * Oled_anim_send - send the runs of a frame record to the Oled
+ * This function support the animation player (Oled_AnimationUpdate)
+ * The record must already be applied to the screen buffer.
+ *
+ * Parameter:
+ * 	data : animation
+ * 	frame: frame record
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_anim_send(const uint8_t *data, const uint8_t *frame)
+{
+	uint16_t x;
+	uint8_t page, n;
+
+	frame++;		//delay
+	while (*frame != ANIM_END)
+	{
+		page = data[ANIM_PAGE] + frame[0];
+		x = data[ANIM_X] + frame[1];
+		n = frame[2];
+		frame += 3 + n;
+
+		if (page >= OLED_PAGESIZE || x >= OLED_COLUMNSIZE)
+			continue;
+		if (n > OLED_COLUMNSIZE - x)
+			n = OLED_COLUMNSIZE - x;
+		Oled_UpdateScreen(x, page * 8, n, 8);
+	}
+}
+
+/* End of Oled_anim.c */
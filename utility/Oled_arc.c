@@ -0,0 +1,924 @@
+/*
+ * Oled_arc.c - Utility to draw large circles, discs, ellipses, arcs and pie
+ * slices with signed 16-bit centers, parts outside the screen are culled.
+ * Oled Graphics library
+ * This Library is based on Universal 8-bit Graphics Library
+ *
+ * This library is use for Tiva Arm Cotex M4
+ * Device: OLED 1.3", 128x64 dot matrix panel
+ * Communication: SPI interface
+ * Driver: SH1106
+ *
+ * Revision: 2.02
+ * Date: 11/11/2016
+ * Author: QUANG
+ */
+ 
+#include "../Oled.h"
+#include <stdint.h>
+#include <stddef.h>
+
+/****************************Private Definitions******************************/
+// A curve walked by the midpoint algorithm: one octant of a circle or one
+// region of a quarter ellipse. The walk variable v goes up by 1 per step, the
+// other coordinate w goes down by 0 or 1. The curve is
+// 	F(v, w) = p*w^2 + q*v^2 - r = 0
+// and w is decremented when the midpoint (v, w-1/2) is outside.
+typedef struct
+{
+	int64_t p;		// coefficient of w^2
+	int64_t q;		// coefficient of v^2
+	int64_t r;		// constant
+	int16_t vMax;	// radius along v
+	int16_t vEnd;	// last point of the walk
+} ARC_CURVE;
+
+// State of the walk at point (v, w): err = F(v, w) and the increments of F
+typedef struct
+{
+	int64_t err;
+	int64_t vchg;	// F(v+1, w) - F(v, w)
+	int64_t wchg;	// F(v, w-1) - F(v, w)
+	int16_t v;
+	int16_t w;
+} ARC_WALK;
+
+// A circular sector from angle start, counterclockwise, to angle start+sweep.
+// Directions are Q15 unit vectors (x right, y up) from Oled_Sin/Oled_Cos.
+typedef struct
+{
+	int32_t sx, sy;		// start direction
+	int32_t ex, ey;		// end direction
+	int16_t start;		// start angle (0 to 359)
+	int16_t sweep;		// 1 to 360 degrees
+	int16_t x0;			// center column (pie slices)
+} ARC_SECTOR;
+
+// An octant of a circle: directions of the offsets and role of the walk
+typedef struct
+{
+	int8_t sx;
+	int8_t sy;
+	bool swap;
+} ARC_OCTANT;
+
+/****************************Private variables********************************/
+//octants in counterclockwise order, octant k covers the angles 45k to 45k+45
+static const ARC_OCTANT g_psArcOctants[8] = {
+		{ 1, -1, true}, { 1, -1, false}, {-1, -1, false}, {-1, -1, true},
+		{-1,  1, true}, {-1,  1, false}, { 1,  1, false}, { 1,  1, true}};
+
+/*************************Private function prototypes*************************/
+static int16_t Oled_curve_w(const ARC_CURVE *c, int16_t v);
+static int16_t Oled_curve_search(const ARC_CURVE *c, int16_t lo, int16_t hi,
+								 int64_t kv, int64_t kw, int64_t lim);
+static bool Oled_circle_visible(int16_t x0, int16_t y0, uint16_t rad, bool fill);
+static void Oled_curve_circle(ARC_CURVE *c, uint16_t rad);
+static void Oled_curve_ellipse(ARC_CURVE *c, uint16_t rv, uint16_t rw);
+static bool Oled_curve_range(const ARC_CURVE *c, int16_t alo, int16_t ahi,
+							 int16_t blo, int16_t bhi, int16_t *va, int16_t *vb);
+static void Oled_walk_start(const ARC_CURVE *c, int16_t v, ARC_WALK *walk);
+static void Oled_walk_step(const ARC_CURVE *c, ARC_WALK *walk);
+static void Oled_axis_range(int16_t c0, int8_t s, int16_t size, int16_t *lo, int16_t *hi);
+static void Oled_curve_plot(const ARC_CURVE *c, int16_t x0, int16_t y0,
+							int8_t sx, int8_t sy, bool swap, const ARC_SECTOR *sector);
+static void Oled_curve_extent(const ARC_CURVE *c, bool swap, int16_t cMin, int16_t n,
+							  int16_t *ext);
+static void Oled_fill_extents(int16_t x0, int16_t y0, int16_t cMin, int16_t n,
+							  int16_t *ext, uint8_t option, const ARC_SECTOR *sector);
+static void Oled_pie_column(int16_t x, int16_t y0, int16_t e, const ARC_SECTOR *sector);
+static bool Oled_sector_init(ARC_SECTOR *sector, int16_t start, int16_t end);
+static bool Oled_sector_octant(const ARC_SECTOR *sector, uint8_t k);
+static bool Oled_sector_contains(const ARC_SECTOR *sector, int32_t px, int32_t py);
+static bool Oled_half_line(int32_t a, int32_t b, int32_t *lo, int32_t *hi);
+
+/****************************Function definitions*****************************/
+
+/******************************************************************************
+ * Oled_DrawLargeCircle - Draw full or part of a large circle
+ * Same points as Oled_DrawCircle, but the center may be anywhere (even far
+ * outside the screen) and the radius is not limited by 8-bit arithmetic.
+ * Each octant only walks the points inside the screen: the first and last
+ * visible points are found by a binary search on the closed form of the walk,
+ * so the parts outside the screen cost nearly nothing.
+ *
+ * Parameter:
+ * 	(x0, y0): circle center
+ * 	rad		: radius (pixel unit)
+ * 	option	: option for drawing
+ * 		- DRAW_UPPER_RIGHT: draw from upper right corner
+ * 		- DRAW_UPPER_LEFT : draw from upper left corner
+ * 		- DRAW_LOWER_LEFT : draw from lower left corner
+ * 		- DRAW_LOWER_RIGHT: draw from lower left corner
+ * 		- DRAW_ALL		  : draw from all corner
+ *
+ * Restriction: rad <= ARC_MAX_RADIUS
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_DrawLargeCircle(int16_t x0, int16_t y0, uint16_t rad, uint8_t option)
+{
+	ARC_CURVE c;
+
+	//sanity check
+	if (rad > ARC_MAX_RADIUS || !Oled_circle_visible(x0, y0, rad, false))
+		return;
+
+	Oled_curve_circle(&c, rad);
+
+	if (option & DRAW_UPPER_RIGHT)
+	{
+		Oled_curve_plot(&c, x0, y0, 1, -1, false, NULL);
+		Oled_curve_plot(&c, x0, y0, 1, -1, true, NULL);
+	}
+	if (option & DRAW_UPPER_LEFT)
+	{
+		Oled_curve_plot(&c, x0, y0, -1, -1, false, NULL);
+		Oled_curve_plot(&c, x0, y0, -1, -1, true, NULL);
+	}
+	if (option & DRAW_LOWER_RIGHT)
+	{
+		Oled_curve_plot(&c, x0, y0, 1, 1, false, NULL);
+		Oled_curve_plot(&c, x0, y0, 1, 1, true, NULL);
+	}
+	if (option & DRAW_LOWER_LEFT)
+	{
+		Oled_curve_plot(&c, x0, y0, -1, 1, false, NULL);
+		Oled_curve_plot(&c, x0, y0, -1, 1, true, NULL);
+	}
+}
+
+/******************************************************************************
+ * Oled_DrawLargeDisc - Draw full or part of a large disc (filled circle)
+ * Same pixels as Oled_DrawDisc, with a signed 16-bit center and a large
+ * radius. Only the columns on the screen are computed and filled, each one
+ * with a single span.
+ *
+ * Parameter:
+ * 	(x0, y0): disc center
+ * 	rad		: radius (pixel unit)
+ * 	option	: option for drawing (DRAW_UPPER_RIGHT ... DRAW_ALL)
+ *
+ * Restriction: rad <= ARC_MAX_RADIUS
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_DrawLargeDisc(int16_t x0, int16_t y0, uint16_t rad, uint8_t option)
+{
+	ARC_CURVE c;
+	int16_t ext[OLED_COLUMNSIZE + 1];
+	int16_t cMin, cMax, i;
+
+	//sanity check
+	if (rad > ARC_MAX_RADIUS || !Oled_circle_visible(x0, y0, rad, true))
+		return;
+
+	//column offsets on the screen, on the left (x0-c) or on the right (x0+c)
+	if (x0 < 0)
+		cMin = -x0;
+	else if (x0 >= OLED_COLUMNSIZE)
+		cMin = x0 - (OLED_COLUMNSIZE - 1);
+	else
+		cMin = 0;
+	cMax = cMin + OLED_COLUMNSIZE - 1;
+	if (cMax > rad)
+		cMax = rad;
+	if (cMin > cMax)
+		return;
+
+	for (i = 0; i <= cMax - cMin + 1; i++)
+		ext[i] = 0;
+	Oled_curve_circle(&c, rad);
+	Oled_curve_extent(&c, false, cMin, cMax - cMin + 1, ext);
+	Oled_curve_extent(&c, true, cMin, cMax - cMin + 1, ext);
+	Oled_fill_extents(x0, y0, cMin, cMax - cMin + 1, ext, option, NULL);
+}
+
+/******************************************************************************
+ * Oled_DrawLargeEllipse - Draw full or part of a large ellipse
+ * Same points as Oled_DrawEllipse, with a signed 16-bit center and large
+ * radii. Both regions of each quarter only walk the points inside the screen.
+ *
+ * Parameter:
+ * 	(x0, y0): ellipse center
+ * 	rx		: horizontal radius (not 0)
+ * 	ry		: vertical radius (not 0)
+ * 	option	: option for drawing (DRAW_UPPER_RIGHT ... DRAW_ALL)
+ *
+ * Restriction: rx, ry <= ARC_MAX_RADIUS
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_DrawLargeEllipse(int16_t x0, int16_t y0, uint16_t rx, uint16_t ry, uint8_t option)
+{
+	ARC_CURVE c1, c2;
+
+	//sanity check, the bounding box must touch the screen
+	if (!rx || !ry || rx > ARC_MAX_RADIUS || ry > ARC_MAX_RADIUS ||
+		x0 + rx < 0 || x0 - rx >= OLED_COLUMNSIZE || y0 + ry < 0 || y0 - ry >= OLED_HEIGHT)
+		return;
+
+	//region 1 walks the rows (v = y), region 2 walks the columns (v = x)
+	Oled_curve_ellipse(&c1, ry, rx);
+	Oled_curve_ellipse(&c2, rx, ry);
+
+	if (option & DRAW_UPPER_RIGHT)
+	{
+		Oled_curve_plot(&c1, x0, y0, 1, -1, true, NULL);
+		Oled_curve_plot(&c2, x0, y0, 1, -1, false, NULL);
+	}
+	if (option & DRAW_UPPER_LEFT)
+	{
+		Oled_curve_plot(&c1, x0, y0, -1, -1, true, NULL);
+		Oled_curve_plot(&c2, x0, y0, -1, -1, false, NULL);
+	}
+	if (option & DRAW_LOWER_RIGHT)
+	{
+		Oled_curve_plot(&c1, x0, y0, 1, 1, true, NULL);
+		Oled_curve_plot(&c2, x0, y0, 1, 1, false, NULL);
+	}
+	if (option & DRAW_LOWER_LEFT)
+	{
+		Oled_curve_plot(&c1, x0, y0, -1, 1, true, NULL);
+		Oled_curve_plot(&c2, x0, y0, -1, 1, false, NULL);
+	}
+}
+
+/******************************************************************************
+ * Oled_DrawLargeFilledEllipse - Draw full or part of a large filled ellipse
+ * Same pixels as Oled_DrawFilledEllipse, with a signed 16-bit center and
+ * large radii. Only the columns on the screen are computed and filled, each
+ * one with a single span.
+ *
+ * Parameter:
+ * 	(x0, y0): ellipse center
+ * 	rx		: horizontal radius (not 0)
+ * 	ry		: vertical radius (not 0)
+ * 	option	: option for drawing (DRAW_UPPER_RIGHT ... DRAW_ALL)
+ *
+ * Restriction: rx, ry <= ARC_MAX_RADIUS
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_DrawLargeFilledEllipse(int16_t x0, int16_t y0, uint16_t rx, uint16_t ry,
+								 uint8_t option)
+{
+	ARC_CURVE c1, c2;
+	int16_t ext[OLED_COLUMNSIZE + 1];
+	int16_t cMin, cMax, i;
+
+	//sanity check, the bounding box must touch the screen
+	if (!rx || !ry || rx > ARC_MAX_RADIUS || ry > ARC_MAX_RADIUS ||
+		x0 + rx < 0 || x0 - rx >= OLED_COLUMNSIZE || y0 + ry < 0 || y0 - ry >= OLED_HEIGHT)
+		return;
+
+	//column offsets on the screen, on the left (x0-c) or on the right (x0+c)
+	if (x0 < 0)
+		cMin = -x0;
+	else if (x0 >= OLED_COLUMNSIZE)
+		cMin = x0 - (OLED_COLUMNSIZE - 1);
+	else
+		cMin = 0;
+	cMax = cMin + OLED_COLUMNSIZE - 1;
+	if (cMax > rx)
+		cMax = rx;
+	if (cMin > cMax)
+		return;
+
+	for (i = 0; i <= cMax - cMin + 1; i++)
+		ext[i] = 0;
+	Oled_curve_ellipse(&c1, ry, rx);
+	Oled_curve_ellipse(&c2, rx, ry);
+	Oled_curve_extent(&c1, true, cMin, cMax - cMin + 1, ext);
+	Oled_curve_extent(&c2, false, cMin, cMax - cMin + 1, ext);
+	Oled_fill_extents(x0, y0, cMin, cMax - cMin + 1, ext, option, NULL);
+}
+
+/******************************************************************************
+ * Oled_DrawArc - Draw an arc of a large circle between 2 angles
+ * The points of Oled_DrawLargeCircle are kept when they lie inside the
+ * sector, which is tested with 2 integer cross products per point. The
+ * octants outside the sector are not walked.
+ *
+ * Parameter:
+ * 	(x0, y0): circle center
+ * 	rad		: radius (pixel unit)
+ * 	start	: start angle in degrees (0: right, 90: up)
+ * 	end		: end angle in degrees, the arc goes counterclockwise from start
+ * 			  to end. end == start draws nothing, end == start+360 draws the
+ * 			  whole circle
+ *
+ * Restriction: rad <= ARC_MAX_RADIUS
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_DrawArc(int16_t x0, int16_t y0, uint16_t rad, int16_t start, int16_t end)
+{
+	ARC_CURVE c;
+	ARC_SECTOR sector;
+	uint8_t k;
+
+	//sanity check
+	if (rad > ARC_MAX_RADIUS || !Oled_circle_visible(x0, y0, rad, false) ||
+		!Oled_sector_init(&sector, start, end))
+		return;
+
+	Oled_curve_circle(&c, rad);
+	for (k = 0; k < 8; k++)
+	{
+		if (Oled_sector_octant(&sector, k))
+			Oled_curve_plot(&c, x0, y0, g_psArcOctants[k].sx, g_psArcOctants[k].sy,
+							g_psArcOctants[k].swap, &sector);
+	}
+}
+
+/******************************************************************************
+ * Oled_DrawPie - Draw a pie slice (filled sector of a large disc)
+ * The columns of Oled_DrawLargeDisc are cut by the 2 rays of the sector:
+ * each column is filled with 1 span (2 spans for some columns of a sector
+ * wider than 180 degrees), with integer math only.
+ *
+ * Parameter:
+ * 	(x0, y0): disc center
+ * 	rad		: radius (pixel unit)
+ * 	start	: start angle in degrees (0: right, 90: up)
+ * 	end		: end angle in degrees, the slice goes counterclockwise from
+ * 			  start to end. end == start draws nothing, end == start+360
+ * 			  draws the whole disc
+ *
+ * Restriction: rad <= ARC_MAX_RADIUS
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_DrawPie(int16_t x0, int16_t y0, uint16_t rad, int16_t start, int16_t end)
+{
+	ARC_CURVE c;
+	ARC_SECTOR sector;
+	int16_t ext[OLED_COLUMNSIZE + 1];
+	int16_t cMin, cMax, i;
+
+	//sanity check
+	if (rad > ARC_MAX_RADIUS || !Oled_circle_visible(x0, y0, rad, true) ||
+		!Oled_sector_init(&sector, start, end))
+		return;
+	sector.x0 = x0;
+
+	//column offsets on the screen, on the left (x0-c) or on the right (x0+c)
+	if (x0 < 0)
+		cMin = -x0;
+	else if (x0 >= OLED_COLUMNSIZE)
+		cMin = x0 - (OLED_COLUMNSIZE - 1);
+	else
+		cMin = 0;
+	cMax = cMin + OLED_COLUMNSIZE - 1;
+	if (cMax > rad)
+		cMax = rad;
+	if (cMin > cMax)
+		return;
+
+	for (i = 0; i <= cMax - cMin + 1; i++)
+		ext[i] = 0;
+	Oled_curve_circle(&c, rad);
+	Oled_curve_extent(&c, false, cMin, cMax - cMin + 1, ext);
+	Oled_curve_extent(&c, true, cMin, cMax - cMin + 1, ext);
+	Oled_fill_extents(x0, y0, cMin, cMax - cMin + 1, ext, DRAW_ALL, &sector);
+}
+
+/******************************************************************************
+ * Oled_curve_w - closed form of the walk
+ * The walk keeps the largest w whose midpoint is inside:
+ * 	F(v, w) + F(v, w-1) <= 0  <=>  2p(w^2 - w) <= 2r - 2qv^2 - p
+ * w is estimated with a square root then corrected with the exact test.
+ *
+ * Parameter:
+ * 	c: the curve
+ * 	v: walk variable (0 to c->vMax)
+ *
+ * Return: w at v
+ *****************************************************************************/
+static int16_t Oled_curve_w(const ARC_CURVE *c, int16_t v)
+{
+	int64_t t, w;
+
+	t = 2 * c->r - 2 * c->q * v * v - c->p;
+	if (t < 0)
+		return 0;
+
+	w = (1 + Oled_Sqrt(1 + 2 * t / c->p)) / 2;
+	while (w > 0 && 2 * c->p * (w * w - w) > t)
+		w--;
+	while (2 * c->p * (w * w + w) <= t)
+		w++;
+	return (int16_t)w;
+}
+
+/******************************************************************************
+ * Oled_curve_search - binary search along a walk
+ * The test kv*v - kw*w(v) > lim (kv, kw >= 0) can only turn from false to true
+ * when v grows, since w(v) never grows.
+ *
+ * Parameter:
+ * 	c		: the curve
+ * 	lo, hi	: search range of v (inside 0..c->vMax)
+ * 	kv, kw	: factors of the test
+ * 	lim		: limit of the test
+ *
+ * Return: first v of lo..hi passing the test, hi+1 if none
+ *****************************************************************************/
+static int16_t Oled_curve_search(const ARC_CURVE *c, int16_t lo, int16_t hi,
+								 int64_t kv, int64_t kw, int64_t lim)
+{
+	int16_t mid, first = hi + 1;
+
+	while (lo <= hi)
+	{
+		mid = lo + (hi - lo) / 2;
+		if (kv * mid - kw * Oled_curve_w(c, mid) > lim)
+		{
+			first = mid;
+			hi = mid - 1;
+		}
+		else
+			lo = mid + 1;
+	}
+	return first;
+}
+
+/******************************************************************************
+ * Oled_circle_visible - quick test before walking a large circle
+ * The points of the walk are less than 1 pixel away from the true circle: a
+ * circle (or disc) missing the screen, or a circle around the whole screen,
+ * draws nothing.
+ *
+ * Parameter:
+ * 	(x0, y0): circle center
+ * 	rad		: radius
+ * 	fill	: true for a disc
+ *
+ * Return: false if nothing can be drawn on the screen
+ *****************************************************************************/
+static bool Oled_circle_visible(int16_t x0, int16_t y0, uint16_t rad, bool fill)
+{
+	int64_t dx, dy, near, far;
+
+	//nearest pixel of the screen
+	dx = (x0 < 0) ? -x0 : (x0 >= OLED_COLUMNSIZE) ? x0 - (OLED_COLUMNSIZE - 1) : 0;
+	dy = (y0 < 0) ? -y0 : (y0 >= OLED_HEIGHT) ? y0 - (OLED_HEIGHT - 1) : 0;
+	near = dx * dx + dy * dy;
+	if (near > ((int64_t)rad + 1) * (rad + 1))
+		return false;
+	if (fill || rad < 2)
+		return true;
+
+	//farthest pixel of the screen
+	dx = (x0 < OLED_COLUMNSIZE / 2) ? (OLED_COLUMNSIZE - 1) - x0 : x0;
+	dy = (y0 < OLED_HEIGHT / 2) ? (OLED_HEIGHT - 1) - y0 : y0;
+	far = dx * dx + dy * dy;
+	return far >= ((int64_t)rad - 1) * (rad - 1);
+}
+
+/******************************************************************************
+ * Oled_curve_circle - set up an octant of a circle
+ * Same walk as Oled_DrawCircle: it stops at the first point past the
+ * diagonal (v >= w).
+ *
+ * Parameter:
+ * 	c  : returned curve
+ * 	rad: radius
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_curve_circle(ARC_CURVE *c, uint16_t rad)
+{
+	c->p = 1;
+	c->q = 1;
+	c->r = (int64_t)rad * rad;
+	c->vMax = rad;
+	c->vEnd = Oled_curve_search(c, 0, rad, 1, 1, -1);
+}
+
+/******************************************************************************
+ * Oled_curve_ellipse - set up a region of a quarter ellipse
+ * Same walk as Oled_DrawEllipse: it goes on while the slope is not steeper
+ * than 1 (q*v <= p*w).
+ *
+ * Parameter:
+ * 	c : returned curve
+ * 	rv: radius along the walk variable
+ * 	rw: radius along the other coordinate
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_curve_ellipse(ARC_CURVE *c, uint16_t rv, uint16_t rw)
+{
+	c->p = (int64_t)rv * rv;
+	c->q = (int64_t)rw * rw;
+	c->r = c->p * c->q;
+	c->vMax = rv;
+	c->vEnd = Oled_curve_search(c, 0, rv, c->q, c->p, 0) - 1;
+}
+
+/******************************************************************************
+ * Oled_curve_range - points of a walk inside a window
+ *
+ * Parameter:
+ * 	c		: the curve
+ * 	alo, ahi: allowed range of v
+ * 	blo, bhi: allowed range of w
+ * 	va, vb	: returned range of v
+ *
+ * Return: true if some points are inside
+ *****************************************************************************/
+static bool Oled_curve_range(const ARC_CURVE *c, int16_t alo, int16_t ahi,
+							 int16_t blo, int16_t bhi, int16_t *va, int16_t *vb)
+{
+	int16_t lo, hi;
+
+	lo = (alo > 0) ? alo : 0;
+	hi = (ahi < c->vEnd) ? ahi : c->vEnd;
+	if (lo > hi || bhi < 0)
+		return false;
+
+	//w goes down: skip the points above bhi, stop before the points below blo
+	if (Oled_curve_w(c, lo) > bhi)
+		lo = Oled_curve_search(c, lo, hi, 0, 1, -(int64_t)bhi - 1);
+	if (blo > 0 && lo <= hi && Oled_curve_w(c, hi) < blo)
+		hi = Oled_curve_search(c, lo, hi, 0, 1, -(int64_t)blo) - 1;
+
+	*va = lo;
+	*vb = hi;
+	return lo <= hi;
+}
+
+/******************************************************************************
+ * Oled_walk_start - start a walk anywhere on the curve
+ *
+ * Parameter:
+ * 	c	: the curve
+ * 	v	: first point
+ * 	walk: returned walk state
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_walk_start(const ARC_CURVE *c, int16_t v, ARC_WALK *walk)
+{
+	int64_t w = Oled_curve_w(c, v);
+
+	walk->v = v;
+	walk->w = (int16_t)w;
+	walk->err = c->p * w * w + c->q * v * v - c->r;
+	walk->vchg = c->q * (2 * v + 1);
+	walk->wchg = c->p * (1 - 2 * w);
+}
+
+/******************************************************************************
+ * Oled_walk_step - go to the next point of a walk
+ *
+ * Parameter:
+ * 	c	: the curve
+ * 	walk: walk state
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_walk_step(const ARC_CURVE *c, ARC_WALK *walk)
+{
+	walk->v++;
+	walk->err += walk->vchg;
+	walk->vchg += 2 * c->q;
+	if (2 * walk->err + walk->wchg > 0)
+	{
+		walk->w--;
+		walk->err += walk->wchg;
+		walk->wchg += 2 * c->p;
+	}
+}
+
+/******************************************************************************
+ * Oled_axis_range - offsets which stay inside the screen on one axis
+ *
+ * Parameter:
+ * 	c0	  : center coordinate
+ * 	s	  : direction of the offsets (1 or -1)
+ * 	size  : screen size on this axis
+ * 	lo, hi: returned offsets, c0 + s*offset is inside 0..size-1
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_axis_range(int16_t c0, int8_t s, int16_t size, int16_t *lo, int16_t *hi)
+{
+	if (s > 0)
+	{
+		*lo = -c0;
+		*hi = size - 1 - c0;
+	}
+	else
+	{
+		*lo = c0 - (size - 1);
+		*hi = c0;
+	}
+}
+
+/******************************************************************************
+ * Oled_curve_plot - draw the visible points of one octant
+ *
+ * Parameter:
+ * 	c		: the curve
+ * 	(x0, y0): center
+ * 	sx, sy	: direction of the octant (1 or -1)
+ * 	swap	: false: v is the column offset, true: v is the row offset
+ * 	sector	: only draw the points inside this sector, NULL for all points
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_curve_plot(const ARC_CURVE *c, int16_t x0, int16_t y0,
+							int8_t sx, int8_t sy, bool swap, const ARC_SECTOR *sector)
+{
+	ARC_WALK walk;
+	int16_t alo, ahi, blo, bhi, va, vb;
+
+	if (swap)
+	{
+		Oled_axis_range(y0, sy, OLED_HEIGHT, &alo, &ahi);
+		Oled_axis_range(x0, sx, OLED_COLUMNSIZE, &blo, &bhi);
+	}
+	else
+	{
+		Oled_axis_range(x0, sx, OLED_COLUMNSIZE, &alo, &ahi);
+		Oled_axis_range(y0, sy, OLED_HEIGHT, &blo, &bhi);
+	}
+	if (!Oled_curve_range(c, alo, ahi, blo, bhi, &va, &vb))
+		return;
+
+	Oled_walk_start(c, va, &walk);
+	while (1)
+	{
+		if (swap)
+		{
+			if (!sector || Oled_sector_contains(sector, sx * walk.w, -sy * walk.v))
+				Oled_DrawPixel(x0 + sx * walk.w, y0 + sy * walk.v, 1);
+		}
+		else if (!sector || Oled_sector_contains(sector, sx * walk.v, -sy * walk.w))
+			Oled_DrawPixel(x0 + sx * walk.v, y0 + sy * walk.w, 1);
+		if (walk.v >= vb)
+			break;
+		Oled_walk_step(c, &walk);
+	}
+}
+
+/******************************************************************************
+ * Oled_curve_extent - record how far columns reach from the center row
+ * Only the columns offsets cMin..cMin+n are recorded (one more than needed:
+ * see Oled_fill_extents).
+ *
+ * Parameter:
+ * 	c	: the curve
+ * 	swap: false: v is the column offset, true: v is the row offset
+ * 	cMin: first column offset
+ * 	n	: number of column offsets
+ * 	ext : column extents, ext[0] is cMin
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_curve_extent(const ARC_CURVE *c, bool swap, int16_t cMin, int16_t n,
+							  int16_t *ext)
+{
+	ARC_WALK walk;
+	int16_t va, vb;
+
+	if (!swap)
+	{
+		if (!Oled_curve_range(c, cMin, cMin + n, 0, INT16_MAX, &va, &vb))
+			return;
+	}
+	else if (!Oled_curve_range(c, 0, INT16_MAX, cMin, cMin + n, &va, &vb))
+		return;
+
+	Oled_walk_start(c, va, &walk);
+	while (1)
+	{
+		if (!swap && ext[walk.v - cMin] < walk.w)
+			ext[walk.v - cMin] = walk.w;
+		else if (swap && ext[walk.w - cMin] < walk.v)
+			ext[walk.w - cMin] = walk.v;
+		if (walk.v >= vb)
+			break;
+		Oled_walk_step(c, &walk);
+	}
+}
+
+/******************************************************************************
+ * Oled_fill_extents - fill the columns of a disc or filled ellipse
+ * A column skipped by the walks (where the 2 regions of an ellipse meet)
+ * reaches at least as far as its outer neighbour.
+ *
+ * Parameter:
+ * 	(x0, y0): center
+ * 	cMin	: first column offset
+ * 	n		: number of column offsets
+ * 	ext		: column extents (n+1 entries)
+ * 	option	: option for drawing (DRAW_UPPER_RIGHT ... DRAW_ALL)
+ * 	sector	: pie slice to fill instead of the quadrant options, or NULL
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_fill_extents(int16_t x0, int16_t y0, int16_t cMin, int16_t n,
+							  int16_t *ext, uint8_t option, const ARC_SECTOR *sector)
+{
+	int16_t c;
+	uint8_t up, down;
+
+	for (c = n; c > 0; c--)
+	{
+		if (ext[c - 1] < ext[c])
+			ext[c - 1] = ext[c];
+	}
+
+	for (c = 0; c < n; c++)
+	{
+		if (sector)
+		{
+			Oled_pie_column(x0 + cMin + c, y0, ext[c], sector);
+			if (cMin + c)
+				Oled_pie_column(x0 - cMin - c, y0, ext[c], sector);
+			continue;
+		}
+		//right column (the center column belongs to both halves), then left column
+		up = option & ((cMin + c) ? DRAW_UPPER_RIGHT : DRAW_UPPER_RIGHT | DRAW_UPPER_LEFT);
+		down = option & ((cMin + c) ? DRAW_LOWER_RIGHT : DRAW_LOWER_RIGHT | DRAW_LOWER_LEFT);
+		if (up || down)
+			Oled_FillColumn(x0 + cMin + c, up ? (int32_t)y0 - ext[c] : y0,
+							down ? (int32_t)y0 + ext[c] : y0);
+		up = option & DRAW_UPPER_LEFT;
+		down = option & DRAW_LOWER_LEFT;
+		if ((cMin + c) && (up || down))
+			Oled_FillColumn(x0 - cMin - c, up ? (int32_t)y0 - ext[c] : y0,
+							down ? (int32_t)y0 + ext[c] : y0);
+	}
+}
+
+/******************************************************************************
+ * Oled_pie_column - fill one column of a pie slice
+ * Each ray of the sector bounds the rows of the column by one side (a half
+ * line). A sector up to 180 degrees keeps the rows on the good side of both
+ * rays; a wider one keeps the rows on the good side of either ray, which may
+ * give 2 spans.
+ *
+ * Parameter:
+ * 	x	  : column position (may be outside the screen)
+ * 	y0	  : center row
+ * 	e	  : extent of the column above and below the center row
+ * 	sector: the pie slice, its center is on the column x0
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_pie_column(int16_t x, int16_t y0, int16_t e, const ARC_SECTOR *sector)
+{
+	int32_t px, lo1, hi1, lo2, hi2;
+	bool in1, in2;
+
+	if (x < 0 || x >= OLED_COLUMNSIZE)
+		return;
+
+	//column offset (x right) and rows of the disc (y up)
+	px = x - sector->x0;
+	lo1 = lo2 = -e;
+	hi1 = hi2 = e;
+	if (sector->sweep >= 360)
+	{
+		Oled_FillColumn(x, (int32_t)y0 - e, (int32_t)y0 + e);
+		return;
+	}
+
+	in1 = Oled_half_line(sector->sx, sector->sy * px, &lo1, &hi1);
+	if (sector->sweep <= 180)
+	{
+		if (in1 && Oled_half_line(-sector->ex, -sector->ey * px, &lo1, &hi1))
+			Oled_FillColumn(x, y0 - hi1, y0 - lo1);
+		return;
+	}
+
+	in2 = Oled_half_line(-sector->ex, -sector->ey * px, &lo2, &hi2);
+	if (in1 && in2 && lo2 <= hi1 + 1 && lo1 <= hi2 + 1)
+	{
+		//overlapping: one span
+		Oled_FillColumn(x, y0 - ((hi1 > hi2) ? hi1 : hi2), y0 - ((lo1 < lo2) ? lo1 : lo2));
+		return;
+	}
+	if (in1)
+		Oled_FillColumn(x, y0 - hi1, y0 - lo1);
+	if (in2)
+		Oled_FillColumn(x, y0 - hi2, y0 - lo2);
+}
+
+/******************************************************************************
+ * Oled_sector_init - set up the sector of an arc or a pie slice
+ *
+ * Parameter:
+ * 	sector: returned sector
+ * 	start : start angle in degrees
+ * 	end	  : end angle in degrees, counterclockwise from start
+ *
+ * Return: false if the sector is empty (start == end)
+ *****************************************************************************/
+static bool Oled_sector_init(ARC_SECTOR *sector, int16_t start, int16_t end)
+{
+	int32_t sweep = (int32_t)end - start;
+
+	if (!sweep)
+		return false;
+
+	//a multiple of 360 degrees is the whole circle
+	sweep %= 360;
+	if (sweep < 0)
+		sweep += 360;
+	sector->sweep = sweep ? sweep : 360;
+	sector->start = ((start % 360) + 360) % 360;
+
+	end = (sector->start + sector->sweep) % 360;
+	sector->sx = Oled_Cos(sector->start);
+	sector->sy = Oled_Sin(sector->start);
+	sector->ex = Oled_Cos(end);
+	sector->ey = Oled_Sin(end);
+	return true;
+}
+
+/******************************************************************************
+ * Oled_sector_octant - test if an octant has some angles inside a sector
+ *
+ * Parameter:
+ * 	sector: the sector
+ * 	k	  : octant (angles 45k to 45k+45)
+ *
+ * Return: true if the octant and the sector overlap
+ *****************************************************************************/
+static bool Oled_sector_octant(const ARC_SECTOR *sector, uint8_t k)
+{
+	int16_t lo = k * 45;
+
+	return ((lo - sector->start + 360) % 360 <= sector->sweep) ||
+		   ((sector->start - lo + 360) % 360 <= 45);
+}
+
+/******************************************************************************
+ * Oled_sector_contains - test if a point is inside a sector
+ * The cross products with the start and the end directions tell on which
+ * side of each ray the point lies; a sweep wider than 180 degrees is the
+ * complement of the narrow sector from end to start.
+ *
+ * Parameter:
+ * 	sector	: the sector
+ * 	(px, py): point relative to the center (x right, y up)
+ *
+ * Return: true if the point is inside
+ *****************************************************************************/
+static bool Oled_sector_contains(const ARC_SECTOR *sector, int32_t px, int32_t py)
+{
+	int32_t c1, c2;
+
+	if (sector->sweep >= 360)
+		return true;
+
+	c1 = sector->sx * py - sector->sy * px;		//left of the start ray
+	c2 = px * sector->ey - py * sector->ex;		//right of the end ray
+	if (sector->sweep <= 180)
+		return c1 >= 0 && c2 >= 0;
+	return c1 >= 0 || c2 >= 0;
+}
+
+/******************************************************************************
+ * Oled_half_line - solve a * py >= b for the integer py
+ *
+ * Parameter:
+ * 	a, b  : the inequality
+ * 	lo, hi: range of py, narrowed to the solutions
+ *
+ * Return: false if no py of lo..hi is a solution
+ *****************************************************************************/
+static bool Oled_half_line(int32_t a, int32_t b, int32_t *lo, int32_t *hi)
+{
+	int32_t q;
+
+	if (a > 0)
+	{
+		//py >= ceil(b / a)
+		q = b / a;
+		if (q * a < b)
+			q++;
+		if (q > *lo)
+			*lo = q;
+	}
+	else if (a < 0)
+	{
+		//py <= floor(b / a)
+		q = b / a;
+		if (q * a < b)
+			q--;
+		if (q < *hi)
+			*hi = q;
+	}
+	else if (b > 0)
+		return false;
+	return *lo <= *hi;
+}
+
+ /* End of Oled_arc.c */
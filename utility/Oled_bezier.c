@@ -0,0 +1,260 @@
+/*
+ * Oled_bezier.c - Utility to draw quadratic and cubic Bezier curves with
+ * fixed-point forward differencing, no floating point.
+ * Oled Graphics library
+ * This Library is based on Universal 8-bit Graphics Library
+ *
+ * This library is use for Tiva Arm Cotex M4
+ * Device: OLED 1.3", 128x64 dot matrix panel
+ * Communication: SPI interface
+ * Driver: SH1106
+ *
+ * Revision: 2.02
+ * Date: 11/11/2016
+ * Author: QUANG
+ */
+ 
+#include "../Oled.h"
+#include <stdint.h>
+
+/****************************Private Definitions******************************/
+#define BEZIER_MAX_SHIFT	8		//at most 2^8 = 256 segments per curve
+#define BEZIER_BATCH		16		//points sent at once to Oled_DrawPolyline
+
+// One coordinate of a curve stepped by forward differencing. The curve is a
+// polynomial of t = i / n (n = 2^shift segments); all the values are scaled
+// by n^3, so they stay exact integers:
+// 	f  = n^3 * B(t)
+// 	d1 = n^3 * (B(t+1/n) - B(t)), d2 and d3 the next differences
+typedef struct
+{
+	int64_t f;
+	int64_t d1;
+	int64_t d2;
+	int64_t d3;
+} BEZIER_AXIS;
+
+/*************************Private function prototypes*************************/
+static uint8_t Oled_bezier_shift(int32_t spread, uint8_t k);
+static bool Oled_bezier_visible(const OLED_POINT *points, uint8_t nPoint);
+static int16_t Oled_bezier_round(int64_t f, uint8_t shift);
+static void Oled_bezier_walk(BEZIER_AXIS *x, BEZIER_AXIS *y, uint8_t shift);
+
+/****************************Function definitions*****************************/
+
+/******************************************************************************
+ * Oled_DrawQuadBezier - draw a quadratic Bezier curve
+ * The curve is cut into 2^k straight segments, k is chosen from the spread of
+ * the control points (second difference) so that a segment is never more
+ * than half a pixel away from the curve. The segments are stepped with
+ * forward differencing in exact fixed point and drawn with Oled_DrawPolyline.
+ * The points may be outside the screen, the curve is clipped.
+ *
+ * Parameter:
+ * 	points: the 3 control points, the curve goes from points[0] to points[2]
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_DrawQuadBezier(const OLED_POINT *points)
+{
+	BEZIER_AXIS x, y;
+	int32_t ax, ay, bx, by, spread;
+	int64_t n;
+	uint8_t shift;
+
+	if (!Oled_bezier_visible(points, 3))
+		return;
+
+	//B(t) = a*t^2 + b*t + p0
+	ax = (int32_t)points[0].x - 2 * points[1].x + points[2].x;
+	ay = (int32_t)points[0].y - 2 * points[1].y + points[2].y;
+	bx = 2 * ((int32_t)points[1].x - points[0].x);
+	by = 2 * ((int32_t)points[1].y - points[0].y);
+
+	//deviation of a segment <= |a| / (4*n^2)
+	spread = (ax < 0) ? -ax : ax;
+	spread = (ay > spread) ? ay : (-ay > spread) ? -ay : spread;
+	shift = Oled_bezier_shift(spread, 1);
+	n = (int64_t)1 << shift;
+
+	x.f = points[0].x * n * n * n;
+	x.d1 = (ax + bx * n) * n;
+	x.d2 = 2 * ax * n;
+	x.d3 = 0;
+	y.f = points[0].y * n * n * n;
+	y.d1 = (ay + by * n) * n;
+	y.d2 = 2 * ay * n;
+	y.d3 = 0;
+	Oled_bezier_walk(&x, &y, shift);
+}
+
+/******************************************************************************
+ * Oled_DrawCubicBezier - draw a cubic Bezier curve
+ * Same method as Oled_DrawQuadBezier, the number of segments is chosen from
+ * the larger second difference of the 4 control points.
+ * The points may be outside the screen, the curve is clipped.
+ *
+ * Parameter:
+ * 	points: the 4 control points, the curve goes from points[0] to points[3]
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_DrawCubicBezier(const OLED_POINT *points)
+{
+	BEZIER_AXIS x, y;
+	int32_t ax, ay, bx, by, cx, cy, spread, d;
+	int64_t n;
+	uint8_t shift, i;
+
+	if (!Oled_bezier_visible(points, 4))
+		return;
+
+	//B(t) = a*t^3 + b*t^2 + c*t + p0
+	ax = 3 * ((int32_t)points[1].x - points[2].x) + points[3].x - points[0].x;
+	ay = 3 * ((int32_t)points[1].y - points[2].y) + points[3].y - points[0].y;
+	bx = 3 * ((int32_t)points[0].x - 2 * points[1].x + points[2].x);
+	by = 3 * ((int32_t)points[0].y - 2 * points[1].y + points[2].y);
+	cx = 3 * ((int32_t)points[1].x - points[0].x);
+	cy = 3 * ((int32_t)points[1].y - points[0].y);
+
+	//deviation of a segment <= 3/4 * max|p[i] - 2*p[i+1] + p[i+2]| / n^2
+	spread = 0;
+	for (i = 0; i < 2; i++)
+	{
+		d = (int32_t)points[i].x - 2 * points[i + 1].x + points[i + 2].x;
+		d = (d < 0) ? -d : d;
+		spread = (d > spread) ? d : spread;
+		d = (int32_t)points[i].y - 2 * points[i + 1].y + points[i + 2].y;
+		d = (d < 0) ? -d : d;
+		spread = (d > spread) ? d : spread;
+	}
+	shift = Oled_bezier_shift(spread, 3);
+	n = (int64_t)1 << shift;
+
+	x.f = points[0].x * n * n * n;
+	x.d1 = ax + (bx + cx * n) * n;
+	x.d2 = 6 * ax + 2 * bx * n;
+	x.d3 = 6 * ax;
+	y.f = points[0].y * n * n * n;
+	y.d1 = ay + (by + cy * n) * n;
+	y.d2 = 6 * ay + 2 * by * n;
+	y.d3 = 6 * ay;
+	Oled_bezier_walk(&x, &y, shift);
+}
+
+/******************************************************************************
+ * Oled_bezier_shift - number of segments of a curve
+ * The deviation of a segment from the curve is at most k * spread / (4*n^2)
+ * pixel; the smallest n = 2^shift keeping it under half a pixel is returned.
+ *
+ * Parameter:
+ * 	spread: largest second difference of the control points
+ * 	k	  : 1 for a quadratic curve, 3 for a cubic curve
+ *
+ * Return: shift, n = 2^shift segments (at most 2^BEZIER_MAX_SHIFT)
+ *****************************************************************************/
+static uint8_t Oled_bezier_shift(int32_t spread, uint8_t k)
+{
+	uint8_t shift = 0;
+
+	//k * spread / (4*n^2) <= 1/2  <=>  k * spread <= 2*n^2
+	while ((shift < BEZIER_MAX_SHIFT) && ((int64_t)k * spread > ((int64_t)2 << (2 * shift))))
+		shift++;
+	return shift;
+}
+
+/******************************************************************************
+ * Oled_bezier_visible - check if a curve may cross the screen
+ * A Bezier curve lies inside the bounding box of its control points.
+ *
+ * Parameter:
+ * 	points: control points
+ * 	nPoint: number of control points
+ *
+ * Return: false if the curve is outside the screen
+ *****************************************************************************/
+static bool Oled_bezier_visible(const OLED_POINT *points, uint8_t nPoint)
+{
+	int16_t xMin, xMax, yMin, yMax;
+	uint8_t i;
+
+	xMin = xMax = points[0].x;
+	yMin = yMax = points[0].y;
+	for (i = 1; i < nPoint; i++)
+	{
+		xMin = (points[i].x < xMin) ? points[i].x : xMin;
+		xMax = (points[i].x > xMax) ? points[i].x : xMax;
+		yMin = (points[i].y < yMin) ? points[i].y : yMin;
+		yMax = (points[i].y > yMax) ? points[i].y : yMax;
+	}
+	return (xMax >= 0) && (xMin < OLED_COLUMNSIZE) && (yMax >= 0) && (yMin < OLED_HEIGHT);
+}
+
+/******************************************************************************
+ * Oled_bezier_round - nearest pixel of a scaled coordinate
+ *
+ * Parameter:
+ * 	f	 : coordinate scaled by 2^shift
+ * 	shift: scale
+ *
+ * Return: the coordinate rounded to a pixel
+ *****************************************************************************/
+static int16_t Oled_bezier_round(int64_t f, uint8_t shift)
+{
+	if (!shift)
+		return (int16_t)f;
+	//floor((f + 1/2) / 2^shift), also for a negative f
+	f += (int64_t)1 << (shift - 1);
+	return (int16_t)((f >= 0) ? (f >> shift) : -((-f + ((int64_t)1 << shift) - 1) >> shift));
+}
+
+/******************************************************************************
+ * Oled_bezier_walk - step a curve and draw its segments
+ * The points of the n = 2^shift segments are computed by adding the forward
+ * differences; consecutive points on the same pixel are merged, the others
+ * are drawn as a polyline by batches of BEZIER_BATCH points.
+ *
+ * Parameter:
+ * 	x	 : x-coordinate of the curve
+ * 	y	 : y-coordinate of the curve
+ * 	shift: n = 2^shift segments
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_bezier_walk(BEZIER_AXIS *x, BEZIER_AXIS *y, uint8_t shift)
+{
+	OLED_POINT batch[BEZIER_BATCH];
+	uint16_t i, n = 1 << shift;
+	uint8_t m;
+	int16_t px, py;
+
+	batch[0].x = Oled_bezier_round(x->f, 3 * shift);
+	batch[0].y = Oled_bezier_round(y->f, 3 * shift);
+	m = 1;
+	for (i = 0; i < n; i++)
+	{
+		x->f += x->d1;
+		x->d1 += x->d2;
+		x->d2 += x->d3;
+		y->f += y->d1;
+		y->d1 += y->d2;
+		y->d2 += y->d3;
+
+		px = Oled_bezier_round(x->f, 3 * shift);
+		py = Oled_bezier_round(y->f, 3 * shift);
+		if ((px == batch[m - 1].x) && (py == batch[m - 1].y))
+			continue;
+		batch[m].x = px;
+		batch[m].y = py;
+		if (++m == BEZIER_BATCH)
+		{
+			//the last point starts the next batch
+			Oled_DrawPolyline(batch, m);
+			batch[0] = batch[m - 1];
+			m = 1;
+		}
+	}
+	Oled_DrawPolyline(batch, m);
+}
+
+/* End of Oled_bezier.c */
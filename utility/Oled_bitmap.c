@@ -15,6 +15,24 @@
  
 #include "../Oled.h"
 
+/****************************Private Definitions******************************/
+#define RLE_CHUNK	32		//bytes sent at once by Oled_SendBitmapRLE
+
+// Decoder of a run-length encoded stream (FONT_FORMAT_RLE packets), one byte
+// at a time
+typedef struct
+{
+	const uint8_t *data;	// next byte of the stream
+	uint8_t ctrl;			// current packet
+	uint8_t count;			// bytes left in the packet
+	uint8_t value;			// repeated byte
+} RLE_STREAM;
+
+/*************************Private function prototypes*************************/
+static void Oled_transpose8(const uint8_t *rows, uint8_t *cols);
+static uint8_t Oled_rop(uint8_t dst, uint8_t src, uint8_t mask, uint8_t rop);
+static uint8_t Oled_rle_next(RLE_STREAM *rle);
+
 /****************************Function definitions*****************************/
 
 /******************************************************************************
@@ -70,6 +88,11 @@ void Oled_DrawBitmap(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t *
  * 	- Byte orientation: Horizontal
  * 	- Size endianess: little
  *
+ * The image is drawn by blocks of 8x8 pixels: the 8 row bytes of a block are
+ * transposed into 8 page bytes, then each page byte is written as a whole
+ * column. Ragged edges (width or height not a multiple of 8) only draw
+ * fewer columns or rows of the last blocks.
+ *
  * Parameter:
  * 	(x,y): upper left position of the image
  * 	w	 : image width in pixel
@@ -81,29 +104,345 @@ void Oled_DrawBitmap(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t *
  *****************************************************************************/
 void Oled_DrawBitmapH(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t *bitmap)
 {
-	uint8_t tmp, tmp_x, tmp_pxl;
+	uint8_t rows[8], cols[8];
+	uint8_t bytes, band, n_row, bx, n_col, i;
 	
 	//sanity check
 	if (x+w > OLED_COLUMNSIZE || y+h > OLED_HEIGHT)
 		return;
 	
-	while(h--)
+	bytes = (w + 7) / 8;	//bytes in a row of the image
+	for (band = 0; band < h; band += 8)
 	{
-		//draw 1 line each loop
-		tmp = w;
-		tmp_x = x;
-		while(tmp)
+		//draw 8 lines each loop
+		n_row = (h - band > 8) ? 8 : h - band;
+		for (bx = 0; bx < bytes; bx++)
 		{
-			tmp_pxl =  tmp >= 8 ? 8 : tmp;
-			//draw maximum 8 bits at once
-			Oled_Draw8Pixel(tmp_x, y, *(bitmap++),tmp_pxl, HORIZONTAL);
-			tmp -= tmp_pxl;
-			tmp_x += tmp_pxl;
+			//the last row of the block goes first (see Oled_transpose8)
+			for (i = 0; i < 8; i++)
+				rows[7 - i] = (i < n_row) ? bitmap[(band + i) * bytes + bx] : 0;
+			Oled_transpose8(rows, cols);
+
+			n_col = (w - bx * 8 > 8) ? 8 : w - bx * 8;
+			for (i = 0; i < n_col; i++)
+				Oled_DrawColumn(x + bx * 8 + i, y + band, n_row, &cols[i], 0);
+		}
+	}
+}
+
+/******************************************************************************
+ * Oled_DrawBitmapScaled - draw a bitmap image enlarged by an integer factor
+ * Same bitmap format as Oled_DrawBitmap (byte orientation: vertical). Every
+ * pixel becomes a scale x scale square; the columns are scaled with the bit
+ * spreading tables of Oled_DrawColumnScaled.
+ * Pixels outside the screen are clipped.
+ *
+ * Parameter:
+ * 	(x,y): upper left position of the scaled image
+ * 	w	 : image width in pixel (not scaled)
+ * 	h	 : image height in pixel (not scaled)
+ * 	scale: scale factor (1 to 4, a larger factor is drawn at 4)
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_DrawBitmapScaled(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t *bitmap,
+						   uint8_t scale)
+{
+	uint16_t tmp_x = x;
+	uint8_t i;
+
+	if (!scale)
+		return;
+	if (scale > 4)		//largest factor of Oled_DrawColumnScaled
+		scale = 4;
+
+	for (i = 0; (i < w) && (tmp_x < OLED_COLUMNSIZE); i++, tmp_x += scale)
+	{
+		//draw 1 column each loop, its page bytes are w bytes apart
+		Oled_DrawColumnScaled((uint8_t)tmp_x, y, h, &bitmap[i], w, scale);
+	}
+}
+
+/******************************************************************************
+ * Oled_DrawBitmapRop - draw a bitmap image with a mask and a raster operation
+ * Same bitmap format as Oled_DrawBitmap (byte orientation: vertical). The
+ * image is drawn one page row at a time: each byte is shifted to the image
+ * row and combined with the 2 screen page bytes it falls on, only the pixels
+ * set in the mask are changed. The image may be partly (or completely)
+ * outside the screen on any edge, it is clipped.
+ *
+ * Parameter:
+ * 	(x,y): upper left position of the image (may be negative)
+ * 	w	 : image width in pixel
+ * 	h	 : image height in pixel
+ * 	mask : pixels to draw (same format and size as the image), 0: all
+ * 	rop	 : raster operation
+ * 		- BITMAP_ROP_COPY  : pixel = image
+ * 		- BITMAP_ROP_OR	   : set the pixels of the image (transparent 0)
+ * 		- BITMAP_ROP_AND   : clear the pixels where the image is 0
+ * 		- BITMAP_ROP_XOR   : invert the pixels of the image
+ * 		- BITMAP_ROP_ERASE : clear the pixels of the image
+ * 		- BITMAP_ROP_INVERT: pixel = inverted image
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_DrawBitmapRop(int16_t x, int16_t y, uint8_t w, uint8_t h, const uint8_t *bitmap,
+						const uint8_t *mask, uint8_t rop)
+{
+	int16_t pTop = (y >= 0) ? y / 8 : -((7 - y) / 8);	//page of the first row
+	uint8_t shift = y - pTop * 8;
+	int16_t c0, c1, page;
+	uint8_t k, rows;
+
+	//columns inside the screen
+	c0 = (x < 0) ? -x : 0;
+	c1 = (x + w > OLED_COLUMNSIZE) ? OLED_COLUMNSIZE - x : w;
+	if (c0 >= c1 || y >= OLED_HEIGHT || y + h <= 0)
+		return;
+
+	for (k = 0; k < (h + 7) / 8; k++, bitmap += w)
+	{
+		//the page row falls on the screen pages page and page+1
+		page = pTop + k;
+		if (page >= OLED_PAGESIZE)
+			break;
+		rows = (h - k * 8 >= 8) ? 0xFF : 0xFF >> (8 - (h - k * 8));
+		Oled_DrawPageRop(x + c0, page, shift, &bitmap[c0], mask ? &mask[k * w + c0] : 0,
+						 (uint16_t)rows << shift, c1 - c0, rop);
+	}
+}
+
+/******************************************************************************
+ * Oled_DrawPageRop - draw one page row of an image with a raster operation
+ * Each image byte is shifted to the image row and combined with the 2 screen
+ * page bytes it falls on: page (low byte) and page+1 (high byte). Pages
+ * outside the screen are skipped. Used by Oled_DrawBitmapRop,
+ * Oled_DrawBitmapRLE and the sprites.
+ *
+ * Parameter:
+ * 	x	  : first column (the n columns must be inside the screen)
+ * 	page  : screen page of the unshifted row (may be negative)
+ * 	shift : image row inside the page (0..7)
+ * 	bitmap: n image bytes
+ * 	mask  : n mask bytes, 0: all pixels
+ * 	rows  : shifted pixels that may change (image height, clipping)
+ * 	n	  : number of columns
+ * 	rop	  : raster operation (see Oled_DrawBitmapRop)
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_DrawPageRop(uint8_t x, int16_t page, uint8_t shift, const uint8_t *bitmap,
+					  const uint8_t *mask, uint16_t rows, uint8_t n, uint8_t rop)
+{
+	uint8_t *column = &Oled_GetBuffer()[x * OLED_PAGESIZE];
+	bool low = (page >= 0 && page < OLED_PAGESIZE && (uint8_t)rows);
+	bool high = (page + 1 >= 0 && page + 1 < OLED_PAGESIZE && (rows >> 8));
+	uint16_t src, msk;
+	uint8_t i;
+
+	if (!low && !high)
+		return;
+
+	for (i = 0; i < n; i++, column += OLED_PAGESIZE)
+	{
+		src = (uint16_t)bitmap[i] << shift;
+		msk = mask ? ((uint16_t)mask[i] << shift) & rows : rows;
+		if (low)
+			column[page] = Oled_rop(column[page], src, msk, rop);
+		if (high)
+			column[page + 1] = Oled_rop(column[page + 1], src >> 8, msk >> 8, rop);
+	}
+}
+
+/******************************************************************************
+ * Oled_DrawBitmapRLE - draw a run-length encoded bitmap image
+ * The image is made by tools/imgconv.py: width, height, then the bytes of a
+ * vertical bitmap (Oled_DrawBitmap layout) packed with the FONT_FORMAT_RLE
+ * packets (literal bytes, zero runs, repeated bytes). The image is decoded
+ * one page row at a time (at most 128 bytes on the stack) and combined into
+ * the screen buffer like Oled_DrawBitmapRop does, no image buffer is needed.
+ * The image is clipped on all edges.
+ *
+ * Parameter:
+ * 	(x,y): upper left position of the image (may be negative)
+ * 	image: encoded image
+ * 	rop	 : raster operation (BITMAP_ROP_COPY ... BITMAP_ROP_INVERT, see
+ * 		   Oled_DrawBitmapRop)
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_DrawBitmapRLE(int16_t x, int16_t y, const uint8_t *image, uint8_t rop)
+{
+	uint8_t w = image[0], h = image[1];
+	int16_t pTop = (y >= 0) ? y / 8 : -((7 - y) / 8);	//page of the first row
+	uint8_t shift = y - pTop * 8;
+	int16_t c0, c1, page, c;
+	uint8_t k, rows, byte;
+	uint8_t row[OLED_COLUMNSIZE];
+	RLE_STREAM rle = {&image[2], 0, 0, 0};
+
+	//columns inside the screen
+	c0 = (x < 0) ? -x : 0;
+	c1 = (x + w > OLED_COLUMNSIZE) ? OLED_COLUMNSIZE - x : w;
+	if (c0 >= c1 || y >= OLED_HEIGHT || y + h <= 0)
+		return;
+
+	for (k = 0; k < (h + 7) / 8; k++)
+	{
+		//the page row falls on the screen pages page and page+1
+		page = pTop + k;
+		if (page >= OLED_PAGESIZE)
+			break;
+		rows = (h - k * 8 >= 8) ? 0xFF : 0xFF >> (8 - (h - k * 8));
+
+		//decode the page row, keep the columns inside the screen
+		for (c = 0; c < w; c++)
+		{
+			byte = Oled_rle_next(&rle);
+			if (c >= c0 && c < c1)
+				row[c - c0] = byte;
+		}
+		Oled_DrawPageRop(x + c0, page, shift, row, 0, (uint16_t)rows << shift, c1 - c0, rop);
+	}
+}
+
+/******************************************************************************
+ * Oled_SendBitmapRLE - send a run-length encoded bitmap straight to the Oled
+ * Same image format as Oled_DrawBitmapRLE. The screen buffer is not used nor
+ * changed: each page row is decoded by chunks of RLE_CHUNK bytes and sent
+ * with Oled_Write, a splash screen needs no buffer at all. The image is
+ * clipped on the right and bottom edges.
+ *
+ * Parameter:
+ * 	x	 : first column of the image
+ * 	page : first page of the image (the image row 0 is the row 8*page)
+ * 	image: encoded image
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_SendBitmapRLE(uint8_t x, uint8_t page, const uint8_t *image)
+{
+	uint8_t chunk[RLE_CHUNK];
+	uint8_t w = image[0], h = image[1];
+	uint8_t k, c, n;
+	RLE_STREAM rle = {&image[2], 0, 0, 0};
+
+	//sanity check
+	if (x >= OLED_COLUMNSIZE)
+		return;
+
+	for (k = 0; (k < (h + 7) / 8) && (page + k < OLED_PAGESIZE); k++)
+	{
+		Oled_SetPosition(x, page + k);
+		for (c = 0, n = 0; c < w; c++)
+		{
+			chunk[n] = Oled_rle_next(&rle);
+			if (x + c >= OLED_COLUMNSIZE)	//decoded, not sent
+				continue;
+			if (++n == RLE_CHUNK)
+			{
+				Oled_Write(chunk, n);
+				n = 0;
+			}
+		}
+		if (n)
+			Oled_Write(chunk, n);
+	}
+}
+
+/******************************************************************************
+ * Oled_rle_next - decode the next byte of a run-length encoded stream
+ * Packets (same as FONT_FORMAT_RLE):
+ * 	- 0nnnnnnn: n+1 literal bytes follow
+ * 	- 10nnnnnn: n+1 zero bytes
+ * 	- 11nnnnnn b: n+2 bytes b
+ *
+ * Parameter:
+ * 	rle: the stream
+ *
+ * Return: the decoded byte
+ *****************************************************************************/
+static uint8_t Oled_rle_next(RLE_STREAM *rle)
+{
+	if (!rle->count)
+	{
+		//read a packet
+		rle->ctrl = *rle->data++;
+		if (!(rle->ctrl & 0x80))			//literal bytes
+			rle->count = rle->ctrl + 1;
+		else if (!(rle->ctrl & 0x40))		//zero bytes
+		{
+			rle->count = (rle->ctrl & 0x3F) + 1;
+			rle->value = 0;
+		}
+		else								//repeated byte
+		{
+			rle->count = (rle->ctrl & 0x3F) + 2;
+			rle->value = *rle->data++;
 		}
-		// u8g_DrawHBitmap(u8g, x, y, cnt, bitmap);
+	}
+
+	rle->count--;
+	return (rle->ctrl & 0x80) ? rle->value : *rle->data++;
+}
 
-		// bitmap += cnt;
-		y++;
-		// h--;
+/******************************************************************************
+ * Oled_rop - combine an image byte with a screen byte
+ *
+ * Parameter:
+ * 	dst	: screen byte
+ * 	src	: image byte
+ * 	mask: bits to change
+ * 	rop	: raster operation (BITMAP_ROP_COPY ... BITMAP_ROP_INVERT)
+ *
+ * Return: the new screen byte
+ *****************************************************************************/
+static uint8_t Oled_rop(uint8_t dst, uint8_t src, uint8_t mask, uint8_t rop)
+{
+	switch (rop)
+	{
+	case BITMAP_ROP_OR:
+		return dst | (src & mask);
+	case BITMAP_ROP_AND:
+		return dst & (~mask | src);
+	case BITMAP_ROP_XOR:
+		return dst ^ (src & mask);
+	case BITMAP_ROP_ERASE:
+		return dst & ~(src & mask);
+	case BITMAP_ROP_INVERT:
+		return (dst & ~mask) | (~src & mask);
+	default:
+		return (dst & ~mask) | (src & mask);
 	}
 }
+
+/******************************************************************************
+ * Oled_transpose8 - transpose a block of 8x8 pixels
+ * Horizontal bytes (left->right: MSB->LSB) are turned into vertical bytes
+ * (up->down: LSB->MSB) with 32-bit shift and mask steps (Hacker's Delight,
+ * transpose8), no loop over the pixels.
+ *
+ * Parameter:
+ * 	rows: the 8 row bytes, bottom row first
+ * 	cols: returned 8 column bytes, left column first
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_transpose8(const uint8_t *rows, uint8_t *cols)
+{
+	uint32_t x, y, t;
+
+	x = ((uint32_t)rows[0] << 24) | ((uint32_t)rows[1] << 16) | ((uint32_t)rows[2] << 8) | rows[3];
+	y = ((uint32_t)rows[4] << 24) | ((uint32_t)rows[5] << 16) | ((uint32_t)rows[6] << 8) | rows[7];
+
+	t = (x ^ (x >> 7)) & 0x00AA00AA;  x = x ^ t ^ (t << 7);
+	t = (y ^ (y >> 7)) & 0x00AA00AA;  y = y ^ t ^ (t << 7);
+	t = (x ^ (x >> 14)) & 0x0000CCCC; x = x ^ t ^ (t << 14);
+	t = (y ^ (y >> 14)) & 0x0000CCCC; y = y ^ t ^ (t << 14);
+	t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+	y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+	x = t;
+
+	cols[0] = x >> 24; cols[1] = x >> 16; cols[2] = x >> 8; cols[3] = x;
+	cols[4] = y >> 24; cols[5] = y >> 16; cols[6] = y >> 8; cols[7] = y;
+}
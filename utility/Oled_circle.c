@@ -17,12 +17,13 @@
 
 /*************************Private function prototypes*************************/
 static void Oled_draw_circle_section(uint8_t x, uint8_t y, uint8_t x0, uint8_t y0, uint8_t option);
-static void Oled_draw_disc_section(uint8_t x, uint8_t y, uint8_t x0, uint8_t y0, uint8_t option);
+static void Oled_draw_styled_circle(uint8_t x0, uint8_t y0, uint8_t rad, uint8_t option);
 
 /****************************Function definitions*****************************/
 
 /******************************************************************************
  * Oled_DrawCircle - Draw full or part of a circle
+ * The circle is drawn with the style set by Oled_SetLineStyle.
  *
  * Parameter:
  * 	(x0, y0): circle center
@@ -38,11 +39,18 @@ static void Oled_draw_disc_section(uint8_t x, uint8_t y, uint8_t x0, uint8_t y0,
  *****************************************************************************/
 void Oled_DrawCircle(uint8_t x0, uint8_t y0, uint8_t rad, uint8_t option)
 {
-	int8_t f;
-	int8_t ddF_x;
-	int8_t ddF_y;
+	int16_t f;
+	int16_t ddF_x;
+	int16_t ddF_y;
 	uint8_t x;
 	uint8_t y;
+
+	if (Oled_GetLineWidth() != 1 || Oled_GetLinePattern() != LINE_PATTERN_SOLID)
+	{
+		Oled_draw_styled_circle(x0, y0, rad, option);
+		return;
+	}
+
 	//calculate, setting up parameter
 	f = 1;
 	f -= rad;
@@ -72,11 +80,15 @@ void Oled_DrawCircle(uint8_t x0, uint8_t y0, uint8_t rad, uint8_t option)
 }
 
 /******************************************************************************
- * Oled_DrawCircle - Draw full or part of a disc (filled circle)
+ * Oled_DrawDisc - Draw full or part of a disc (filled circle)
+ * The midpoint walk only records how far each column reaches from the
+ * center row; then every column is filled once from its top to its bottom,
+ * upper and lower quadrants merged into one span. Columns outside the screen
+ * are skipped, so the center may lie near or beyond the screen border.
  *
  * Parameter:
  * 	(x0, y0): disc center
- * 	rad		: disc corner (2*pi for whole circle) in radian
+ * 	rad		: radius (pixel unit)
  * 	opt		: option for drawing
  * 		- DRAW_UPPER_RIGHT: draw from upper right corner
  * 		- DRAW_UPPER_LEFT : draw from upper left corner
@@ -88,26 +100,40 @@ void Oled_DrawCircle(uint8_t x0, uint8_t y0, uint8_t rad, uint8_t option)
  *****************************************************************************/
 void Oled_DrawDisc(uint8_t x0, uint8_t y0, uint8_t rad, uint8_t option)
 {
-	int8_t f;
-	int8_t ddF_x;
-	int8_t ddF_y;
+	uint8_t ext[OLED_COLUMNSIZE];	//extent of the columns cMin..cMin+n-1
+	uint8_t cMin, n, c;
+	uint8_t up, down;
+	int16_t f;
+	int16_t ddF_x;
+	int16_t ddF_y;
 	uint8_t x;
 	uint8_t y;
+
+	//a column offset c is visible on the left (x0-c) or on the right (x0+c)
+	cMin = (x0 >= OLED_COLUMNSIZE) ? x0 - (OLED_COLUMNSIZE - 1) : 0;
+	if (cMin > rad)
+		return;
+	n = (rad - cMin >= OLED_COLUMNSIZE) ? OLED_COLUMNSIZE : rad - cMin + 1;
+	for (c = 0; c < n; c++)
+		ext[c] = 0;
+
 	//calculate, setting up parameter
-	f = 1;
-	f -= rad;
+	f = 1 - rad;
 	ddF_x = 1;
-	ddF_y = 0;
-	ddF_y -= rad;
-	ddF_y *= 2;
+	ddF_y = -2 * rad;
 	x = 0;
 	y = rad;
 
-	Oled_draw_disc_section(x, y, x0, y0, option);
-	//Draw
-	while (x < y)
+	//walk one octant, each point gives the extent of 2 columns
+	while (1)
 	{
-		if (f >= 0) 
+		if ((uint8_t)(x - cMin) < n && ext[x - cMin] < y)
+			ext[x - cMin] = y;
+		if ((uint8_t)(y - cMin) < n && ext[y - cMin] < x)
+			ext[y - cMin] = x;
+		if (x >= y)
+			break;
+		if (f >= 0)
 		{
 			y--;
 			ddF_y += 2;
@@ -116,8 +142,22 @@ void Oled_DrawDisc(uint8_t x0, uint8_t y0, uint8_t rad, uint8_t option)
 		x++;
 		ddF_x += 2;
 		f += ddF_x;
+	}
 
-		Oled_draw_disc_section(x, y, x0, y0, option);
+	//fill each column once
+	for (c = 0; c < n; c++)
+	{
+		//right column (the center column belongs to both halves), then left column
+		up = option & ((cMin + c) ? DRAW_UPPER_RIGHT : DRAW_UPPER_RIGHT | DRAW_UPPER_LEFT);
+		down = option & ((cMin + c) ? DRAW_LOWER_RIGHT : DRAW_LOWER_RIGHT | DRAW_LOWER_LEFT);
+		if (up || down)
+			Oled_FillColumn((int16_t)x0 + cMin + c, up ? (int16_t)y0 - ext[c] : y0,
+							down ? (int16_t)y0 + ext[c] : y0);
+		up = option & DRAW_UPPER_LEFT;
+		down = option & DRAW_LOWER_LEFT;
+		if ((cMin + c) && (up || down))
+			Oled_FillColumn((int16_t)x0 - cMin - c, up ? (int16_t)y0 - ext[c] : y0,
+							down ? (int16_t)y0 + ext[c] : y0);
 	}
 }
 
@@ -169,51 +209,100 @@ static void Oled_draw_circle_section(uint8_t x, uint8_t y, uint8_t x0, uint8_t y
 }
 
 /******************************************************************************
- * Oled_draw_disc_section - a minor step when drawing a disc
- * This function support the draw disc function (Oled_DrawDisc)
- * This function draw a vertical line at a specific location by the parameters
+ * Oled_draw_styled_circle - draw a wide or dashed circle
+ * Same walk as Oled_DrawCircle. Each step advances the dash pattern (the 8
+ * octants are mirrored, so the dashes are symmetric); when its bit is set,
+ * every octant point is drawn as a span across the walk direction: a column
+ * near the top and bottom, a row near the left and right. The span is
+ * longer than the width by rad / y, the slope factor of the octant.
+ * Where the octants meet (45 degrees) the column and the row spans leave the
+ * outer corners of a '+' empty, a square of side width / sqrt(2) fills them.
  *
  * Parameter:
- * 	(x, y): a first point of a line (already calculate by the draw disc function)
- * 	(x0, y0): disc center
- * 	option: option for drawing
- * 		- DRAW_UPPER_RIGHT: draw from upper right corner
- * 		- DRAW_UPPER_LEFT : draw from upper left corner
- * 		- DRAW_LOWER_LEFT : draw from lower left corner
- * 		- DRAW_LOWER_RIGHT: draw from lower left corner
- * 		- DRAW_ALL		  : draw from all corner
+ * 	(x0, y0): circle center
+ * 	rad		: radius (pixel unit)
+ * 	option	: option for drawing (DRAW_UPPER_RIGHT ... DRAW_ALL)
  *
  * Return: none
  *****************************************************************************/
-static void Oled_draw_disc_section(uint8_t x, uint8_t y, uint8_t x0, uint8_t y0, uint8_t option)
+static void Oled_draw_styled_circle(uint8_t x0, uint8_t y0, uint8_t rad, uint8_t option)
 {
-    /* upper right */
-    if ( option & DRAW_UPPER_RIGHT )
-    {
-      Oled_DrawVLine(x0+x, y0-y, y+1);
-      Oled_DrawVLine(x0+y, y0-x, x+1);
-    }
-    
-    /* upper left */
-    if ( option & DRAW_UPPER_LEFT )
-    {
-      Oled_DrawVLine(x0-x, y0-y, y+1);
-      Oled_DrawVLine(x0-y, y0-x, x+1);
-    }
-    
-    /* lower right */
-    if ( option & DRAW_LOWER_RIGHT )
-    {
-      Oled_DrawVLine(x0+x, y0, y+1);
-      Oled_DrawVLine(x0+y, y0, x+1);
-    }
-    
-    /* lower left */
-    if ( option & DRAW_LOWER_LEFT )
-    {
-      Oled_DrawVLine(x0-x, y0, y+1);
-      Oled_DrawVLine(x0-y, y0, x+1);
-    }
+	uint16_t pattern = Oled_GetLinePattern();
+	uint8_t width = Oled_GetLineWidth();
+	int16_t f, ddF_x, ddF_y;
+	int16_t x, y;
+	int16_t a, i, d;
+	uint16_t t;
+	uint8_t step;
+	bool on = false;
+
+	f = 1 - rad;
+	ddF_x = 1;
+	ddF_y = -2 * rad;
+	x = 0;
+	y = rad;
+	step = 0;
+
+	while (1)
+	{
+		on = (pattern & (1 << step)) != 0;
+		if (on)
+		{
+			//y < x only at the last point, past 45 degrees
+			d = (y > x) ? y : x;
+			t = d ? width * rad / d : width;
+
+			if (option & DRAW_UPPER_RIGHT)
+			{
+				Oled_DrawSpan(x0 + x, y0 - y, t, false);
+				Oled_DrawSpan(x0 + y, y0 - x, t, true);
+			}
+			if (option & DRAW_UPPER_LEFT)
+			{
+				Oled_DrawSpan(x0 - x, y0 - y, t, false);
+				Oled_DrawSpan(x0 - y, y0 - x, t, true);
+			}
+			if (option & DRAW_LOWER_RIGHT)
+			{
+				Oled_DrawSpan(x0 + x, y0 + y, t, false);
+				Oled_DrawSpan(x0 + y, y0 + x, t, true);
+			}
+			if (option & DRAW_LOWER_LEFT)
+			{
+				Oled_DrawSpan(x0 - x, y0 + y, t, false);
+				Oled_DrawSpan(x0 - y, y0 + x, t, true);
+			}
+		}
+		step = (step + 1) & 0x0F;
+
+		if (x >= y)
+			break;
+		if (f >= 0)
+		{
+			y--;
+			ddF_y += 2;
+			f += ddF_y;
+		}
+		x++;
+		ddF_x += 2;
+		f += ddF_x;
+	}
+
+	//square at the 45 degree points: half side width / (2 * sqrt(2))
+	a = (width * 181) >> 9;
+	if (!on || !a)
+		return;
+	for (i = -a; i <= a; i++)
+	{
+		if (option & DRAW_UPPER_RIGHT)
+			Oled_DrawSpan(x0 + x + i, y0 - y, 2 * a + 1, false);
+		if (option & DRAW_UPPER_LEFT)
+			Oled_DrawSpan(x0 - x + i, y0 - y, 2 * a + 1, false);
+		if (option & DRAW_LOWER_RIGHT)
+			Oled_DrawSpan(x0 + x + i, y0 + y, 2 * a + 1, false);
+		if (option & DRAW_LOWER_LEFT)
+			Oled_DrawSpan(x0 - x + i, y0 + y, 2 * a + 1, false);
+	}
 }
 
  /* End of Oled_circle.c */
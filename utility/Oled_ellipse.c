@@ -17,7 +17,7 @@
  
 /*************************Private function prototypes*************************/
 static void Oled_draw_ellipse_section(uint8_t x, uint8_t y, uint8_t x0, uint8_t y0, uint8_t option);
-static void Oled_draw_filled_ellipse_section(uint8_t x, uint8_t y, uint8_t x0, uint8_t y0, uint8_t option);
+static void Oled_ellipse_extent(uint8_t *ext, uint8_t cMin, uint8_t n, uint8_t x, uint8_t y);
 
 /****************************Function definitions*****************************/
 
@@ -99,6 +99,11 @@ void Oled_DrawEllipse(uint8_t x0, uint8_t y0, uint8_t rx, uint8_t ry, uint8_t op
 
 /******************************************************************************
  * Oled_DrawFilledEllipse - Draw filled ellipse
+ * Both regions of the ellipse walk only record how far each column reaches
+ * from the center row; then every column is filled once from its top to its
+ * bottom, upper and lower quadrants merged into one span. Columns outside the
+ * screen are skipped. A column skipped by the walk where the 2 regions meet
+ * (flat ellipses) is filled too.
  *
  * Parameter:
  * 	(x0, y0): ellipse center
@@ -115,12 +120,23 @@ void Oled_DrawEllipse(uint8_t x0, uint8_t y0, uint8_t rx, uint8_t ry, uint8_t op
  *****************************************************************************/
 void Oled_DrawFilledEllipse(uint8_t x0, uint8_t y0, uint8_t rx, uint8_t ry, uint8_t option)
 {
+  uint8_t ext[OLED_COLUMNSIZE];   //extent of the columns cMin..cMin+n-1
+  uint8_t cMin, n, c;
+  uint8_t up, down;
   uint8_t x, y;
   long xchg, ychg;
   long err;
   long rxrx2;
   long ryry2;
   long stopx, stopy;
+
+  //a column offset c is visible on the left (x0-c) or on the right (x0+c)
+  cMin = (x0 >= OLED_COLUMNSIZE) ? x0 - (OLED_COLUMNSIZE - 1) : 0;
+  if ( cMin > rx )
+    return;
+  n = (rx - cMin >= OLED_COLUMNSIZE) ? OLED_COLUMNSIZE : rx - cMin + 1;
+  for ( c = 0; c < n; c++ )
+    ext[c] = 0;
   
   rxrx2 = rx*rx*2;
   ryry2 = ry*ry*2;
@@ -134,7 +150,7 @@ void Oled_DrawFilledEllipse(uint8_t x0, uint8_t y0, uint8_t rx, uint8_t ry, uint
   
   while( stopx >= stopy )
   {
-    Oled_draw_filled_ellipse_section(x, y, x0, y0, option);
+    Oled_ellipse_extent(ext, cMin, n, x, y);
     y++;
     stopy += rxrx2;
     err += ychg;
@@ -158,7 +174,7 @@ void Oled_DrawFilledEllipse(uint8_t x0, uint8_t y0, uint8_t rx, uint8_t ry, uint
 
   while( stopx <= stopy )
   {
-    Oled_draw_filled_ellipse_section(x, y, x0, y0, option);
+    Oled_ellipse_extent(ext, cMin, n, x, y);
     x++;
     stopx += ryry2;
     err += xchg;
@@ -170,7 +186,31 @@ void Oled_DrawFilledEllipse(uint8_t x0, uint8_t y0, uint8_t rx, uint8_t ry, uint
       err += ychg;
       ychg += rxrx2;
     }
-  } 
+  }
+
+  //the 2 regions may leave a column without point where they meet: a column
+  //reaches at least as far as its outer neighbour
+  for ( c = n - 1; c > 0; c-- )
+  {
+    if ( ext[c - 1] < ext[c] )
+      ext[c - 1] = ext[c];
+  }
+
+  //fill each column once
+  for ( c = 0; c < n; c++ )
+  {
+    //right column (the center column belongs to both halves), then left column
+    up = option & ((cMin + c) ? DRAW_UPPER_RIGHT : DRAW_UPPER_RIGHT | DRAW_UPPER_LEFT);
+    down = option & ((cMin + c) ? DRAW_LOWER_RIGHT : DRAW_LOWER_RIGHT | DRAW_LOWER_LEFT);
+    if ( up || down )
+      Oled_FillColumn((int16_t)x0 + cMin + c, up ? (int16_t)y0 - ext[c] : y0,
+                      down ? (int16_t)y0 + ext[c] : y0);
+    up = option & DRAW_UPPER_LEFT;
+    down = option & DRAW_LOWER_LEFT;
+    if ( (cMin + c) && (up || down) )
+      Oled_FillColumn((int16_t)x0 - cMin - c, up ? (int16_t)y0 - ext[c] : y0,
+                      down ? (int16_t)y0 + ext[c] : y0);
+  }
 }
 
 /******************************************************************************
@@ -217,48 +257,24 @@ static void Oled_draw_ellipse_section(uint8_t x, uint8_t y, uint8_t x0, uint8_t
 }
 
 /******************************************************************************
- * Oled_draw_filled_ellipse_section - a minor step when drawing a filled ellipse
+ * Oled_ellipse_extent - record a point of a filled ellipse
  * This function support the draw filled ellipse function (Oled_DrawFilledEllipse)
- * This function draw a vertical line at a specific location by the parameters
+ * The extent of column x is the largest y of its points.
  *
  * Parameter:
- * 	(x, y): a first point of a line (already calculate by the draw filled
- * 	ellipse function)
- * 	(x0, y0): ellipse center
- * 	option: option for drawing
- * 		- DRAW_UPPER_RIGHT: draw from upper right corner
- * 		- DRAW_UPPER_LEFT : draw from upper left corner
- * 		- DRAW_LOWER_LEFT : draw from lower left corner
- * 		- DRAW_LOWER_RIGHT: draw from lower left corner
- * 		- DRAW_ALL		  : draw from all corner
+ * 	ext	  : column extents, ext[0] is the column offset cMin
+ * 	cMin  : first recorded column offset
+ * 	n	  : number of recorded columns
+ * 	(x, y): a point of the quarter ellipse (relative to the center)
  *
  * Return: none
  *****************************************************************************/
-static void Oled_draw_filled_ellipse_section(uint8_t x, uint8_t y, uint8_t x0, uint8_t y0, uint8_t option)
+static void Oled_ellipse_extent(uint8_t *ext, uint8_t cMin, uint8_t n, uint8_t x, uint8_t y)
 {
-    /* upper right */
-    if ( option & DRAW_UPPER_RIGHT )
-    {
-      Oled_DrawVLine(x0+x, y0-y, y+1);
-    }
-    
-    /* upper left */
-    if ( option & DRAW_UPPER_LEFT )
-    {
-      Oled_DrawVLine(x0-x, y0-y, y+1);
-    }
-    
-    /* lower right */
-    if ( option & DRAW_LOWER_RIGHT )
-    {
-      Oled_DrawVLine(x0+x, y0, y+1);
-    }
-    
-    /* lower left */
-    if ( option & DRAW_LOWER_LEFT )
-    {
-      Oled_DrawVLine(x0-x, y0, y+1);
-    }
+    if ( x < cMin || x - cMin >= n )
+      return;
+    if ( ext[x - cMin] < y )
+      ext[x - cMin] = y;
 }
 
  /* End of Oled_ellipse.c */
@@ -0,0 +1,116 @@
+/*
+ * Oled_label.c - Text labels which only redraw the changed characters
+ * Oled Graphics library
+ *
+ * A label remembers the text on screen and the x offset of every character.
+ * When the label is printed again, only the characters whose value or
+ * position changed are redrawn and marked dirty, and the tail left by a
+ * shorter text is cleared. For a monospace font, updating a number usually
+ * costs one or two glyphs instead of the whole line.
+ *
+ * This library is use for Tiva Arm Cotex M4
+ * Device: OLED 1.3", 128x64 dot matrix panel
+ * Communication: SPI interface
+ * Driver: SH1106
+ *
+ * Revision: 2.02
+ * Author: QUANG
+ */
+
+#include "../Oled.h"
+
+/****************************Function definitions*****************************/
+
+/******************************************************************************
+ * Oled_LabelInit - Initialize a label
+ * Nothing is drawn, the first Oled_LabelPrintf draws the whole text.
+ *
+ * Parameter:
+ * 	label	: the label
+ * 	(x, y)	: upper left position of the label
+ * 	maxWidth: maximum width of the text (pixel), the text is cut at this width
+ * 	font	: font of the label
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_LabelInit(OLED_LABEL *label, uint8_t x, uint8_t y, uint8_t maxWidth,
+					FONT_INFO *font)
+{
+	label->x = x;
+	label->y = y;
+	label->maxWidth = maxWidth;
+	label->font = font;
+	label->len = 0;
+	label->xoff[0] = 0;
+}
+
+/******************************************************************************
+ * Oled_LabelPrintf - Print a formatted text to a label
+ * The format characters are the same as in Oled_printf, the text is UTF-8.
+ * Changed characters are drawn to the screen buffer and marked dirty, use
+ * Oled_UpdateDirty to send them to the Oled.
+ *
+ * Parameter:
+ * 	label	: the label
+ * 	pcString: format string
+ * 	...		: arguments of the format string
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_LabelPrintf(OLED_LABEL *label, const char *pcString, ...)
+{
+	char pcBuf[LABEL_MAX_CHARS * 3 + 1];	//UTF-8: up to 3 bytes per character
+	const char *str = pcBuf;
+	va_list vaArgP;
+	FONT_INFO *font;
+	uint16_t code, left;
+	uint8_t i, x, w, oldWidth, height;
+
+	va_start(vaArgP, pcString);
+	Oled_vsnprintf(pcBuf, sizeof(pcBuf), pcString, vaArgP);
+	va_end(vaArgP);
+
+	font = Oled_GetFont();
+	Oled_SetFont(label->font);
+	height = Oled_FontHeight();
+	oldWidth = label->xoff[label->len];
+
+	x = 0;
+	for (i = 0; *str && (i < LABEL_MAX_CHARS); i++)
+	{
+		code = Oled_NextChar(&str);
+		w = Oled_CharWidth(code);
+		if (w > label->maxWidth - x)	//cut the text
+			break;
+
+		//redraw the character only if it changed or moved (and is on screen)
+		left = label->x + x;
+		if (((i >= label->len) || (code != label->text[i])
+			 || (x != label->xoff[i])) && (left < OLED_COLUMNSIZE))
+		{
+			Oled_DrawChar(left, label->y, code);
+			Oled_MarkDirty(left, label->y, w, height);
+		}
+
+		label->text[i] = code;
+		label->xoff[i] = x;
+		x += w;
+	}
+	label->len = i;
+	label->xoff[i] = x;
+
+	//clear the tail of the previous text, clipped to the screen
+	left = label->x + x;
+	if ((oldWidth > x) && (left < OLED_COLUMNSIZE) && (label->y < OLED_HEIGHT))
+	{
+		w = (oldWidth - x > OLED_COLUMNSIZE - left) ? OLED_COLUMNSIZE - left : oldWidth - x;
+		if (height > OLED_HEIGHT - label->y)
+			height = OLED_HEIGHT - label->y;
+		Oled_Clear(left, label->y, w, height);
+		Oled_MarkDirty(left, label->y, w, height);
+	}
+
+	Oled_SetFont(font);
+}
+
+/* End of Oled_label.c */
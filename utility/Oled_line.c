@@ -17,10 +17,61 @@
 /****************************Private Definitions******************************/
 #define swap(x,y) tmp=(x);(x)=(y);(y)=tmp
 
+/****************************Private variables********************************/
+static uint8_t lineWidth = 1;						//stroke width in pixel
+static uint16_t linePattern = LINE_PATTERN_SOLID;	//dash pattern, bit 0 first
+
+/*************************Private function prototypes*************************/
+static void Oled_draw_styled_line(int16_t x1, int16_t y1, int16_t x2, int16_t y2);
+
 /****************************Function definitions*****************************/
 
+/******************************************************************************
+ * Oled_SetLineStyle - set the stroke of the outlines
+ * The style is used by Oled_DrawLine, Oled_DrawFrame, Oled_DrawRFrame and
+ * Oled_DrawCircle. The other shapes are not affected.
+ *
+ * Parameter:
+ * 	width  : stroke width in pixel (1 is a thin line)
+ * 	pattern: dash pattern, one bit per step along the line (bit 0 first,
+ * 			 1: drawn), repeated every 16 steps. LINE_PATTERN_SOLID,
+ * 			 LINE_PATTERN_DOTTED, LINE_PATTERN_DASHED or any 16-bit value
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_SetLineStyle(uint8_t width, uint16_t pattern)
+{
+	lineWidth = width ? width : 1;
+	linePattern = pattern;
+}
+
+/******************************************************************************
+ * Oled_GetLineWidth - get the stroke width set by Oled_SetLineStyle
+ *
+ * Parameter: none
+ *
+ * Return: stroke width in pixel
+ *****************************************************************************/
+uint8_t Oled_GetLineWidth(void)
+{
+	return lineWidth;
+}
+
+/******************************************************************************
+ * Oled_GetLinePattern - get the dash pattern set by Oled_SetLineStyle
+ *
+ * Parameter: none
+ *
+ * Return: dash pattern
+ *****************************************************************************/
+uint16_t Oled_GetLinePattern(void)
+{
+	return linePattern;
+}
+
 /******************************************************************************
  * Draw a line from (x1, y1) to (x2, y2)
+ * The line is drawn with the style set by Oled_SetLineStyle.
  *
  * Parameter:
  * 	x1,y1: position of the first point
@@ -38,6 +89,12 @@ void Oled_DrawLine(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2)
 
 	bool swapxy = false;
 
+	if (lineWidth != 1 || linePattern != LINE_PATTERN_SOLID)
+	{
+		Oled_draw_styled_line(x1, y1, x2, y2);
+		return;
+	}
+
 	/* no BBX intersection check at the moment, should be added... */
 
 	dx = ( x1 > x2 ) ? (x1-x2) : (x2-x1);
@@ -72,4 +129,71 @@ void Oled_DrawLine(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2)
 	}
 }
 
+/******************************************************************************
+ * Oled_draw_styled_line - draw a wide or dashed line
+ * Same Bresenham walk as Oled_DrawLine (from the left end, or the top end
+ * of a steep line). Each step advances the dash pattern; when its bit is set
+ * a span across the major axis is drawn: a column for a flat line, a row for
+ * a steep line. The span is longer than the width by the slope factor
+ * (length / major axis), so the stroke keeps its width at any angle.
+ *
+ * Parameter:
+ * 	x1,y1: position of the first point
+ * 	x2,y2: position of the second point
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_draw_styled_line(int16_t x1, int16_t y1, int16_t x2, int16_t y2)
+{
+	int16_t tmp;
+	int16_t x, y, dx, dy, err, ystep;
+	uint32_t len;
+	uint8_t t, step;
+	bool swapxy = false;
+
+	dx = (x1 > x2) ? (x1 - x2) : (x2 - x1);
+	dy = (y1 > y2) ? (y1 - y2) : (y2 - y1);
+
+	//span length: width * length / major axis, rounded (length in 1/16 pixel)
+	t = lineWidth;
+	if (t > 1 && dx && dy)
+	{
+		len = Oled_Sqrt(((uint32_t)dx * dx + (uint32_t)dy * dy) << 8);
+		tmp = (dx > dy) ? dx : dy;
+		len = (lineWidth * len + 8 * tmp) / (16 * tmp);
+		t = (len > 255) ? 255 : len;
+	}
+
+	if (dy > dx)
+	{
+		swapxy = true;
+		swap(dx,dy);
+		swap(x1,y1);
+		swap(x2,y2);
+	}
+
+	if (x1 > x2)
+	{
+		swap(x1,x2);
+		swap(y1,y2);
+	}
+
+	err = dx >> 1;
+	ystep = (y2 > y1) ? 1 : -1;
+	y = y1;
+	step = 0;
+	for (x = x1; x <= x2; x++)
+	{
+		if (linePattern & (1 << step))
+			swapxy ? Oled_DrawSpan(y, x, t, true) : Oled_DrawSpan(x, y, t, false);
+		step = (step + 1) & 0x0F;
+		err -= dy;
+		if (err < 0)
+		{
+			y += ystep;
+			err += dx;
+		}
+	}
+}
+
 /* End of Oled_line.c */
@@ -1,6 +1,7 @@
 /*
  * Oled_polygon.c - Implementation of a polygon drawing algorithm for "convex"
- * polygons.
+ * polygons, and a scanline filler for any polygon (concave or
+ * self-intersecting).
  * Oled Graphics library
  * This Library is based on Universal 8-bit Graphics Library
  *
@@ -21,9 +22,36 @@
 /****************************Private Definitions******************************/
 #define swap(x,y) tmp=(x);(x)=(y);(y)=tmp
 
+// Oled_draw_clipped_line: end points not drawn (already drawn by the
+// previous or next segment of a polyline)
+#define LINE_SKIP_FIRST		0x01
+#define LINE_SKIP_LAST		0x02
+// Oled_draw_clipped_line: pixels drawn with the fill pattern (outline of a
+// filled polygon)
+#define LINE_FILL			0x04
+
+// An edge of a polygon for the scanline filler. Columns are scanned from left
+// to right, the edge covers the columns xa <= x < xb and its y-coordinate is
+// stepped exactly (integer part y, fraction rem/dx) at every column.
+typedef struct
+{
+	int16_t xa;		// first column
+	int16_t xb;		// first column after the edge
+	int32_t y;		// y at the current column, rounded down
+	int32_t q;		// y step per column, rounded down
+	uint16_t rem;	// fraction of y (rem/dx)
+	uint16_t r;		// fraction of the y step (r/dx)
+	uint16_t dx;	// xb - xa
+	int8_t dir;		// 1: edge goes right, -1: edge goes left (nonzero rule)
+} POLYGON_EDGE;
+
 /*************************Private function prototypes*************************/
-static void Oled_draw_filled_triangle_section(uint8_t x0, uint8_t y0,
-							uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2);
+static void Oled_trace_edge(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2,
+							uint8_t *top, uint8_t *bottom);
+static bool Oled_edge_below(const POLYGON_EDGE *e1, const POLYGON_EDGE *e2);
+static void Oled_fill_span(int16_t x, const POLYGON_EDGE *top, const POLYGON_EDGE *bottom);
+static void Oled_draw_clipped_line(int16_t x1, int16_t y1, int16_t x2, int16_t y2,
+								   uint8_t skip);
 
 /****************************Function definitions*****************************/
 
@@ -42,35 +70,92 @@ static void Oled_draw_filled_triangle_section(uint8_t x0, uint8_t y0,
 void Oled_DrawPolygon(uint8_t nPoint, ...)
 {
 	va_list vaArgP;
-	uint8_t x0, y0, x1, y1, x2, y2;
+	uint8_t x0, y0, x1, y1, x2, y2, skip = 0;
 	
 	//sanity check
 	if (nPoint < 2)
 		return;
 	
 	va_start(vaArgP,nPoint);	// Start the varargs processing.
-	//Get the first point of the polygon
-	x0 = va_arg(vaArgP,uint8_t);
-	y0 = va_arg(vaArgP,uint8_t);
+	//Get the first point of the polygon (uint8_t arguments are passed as int)
+	x0 = va_arg(vaArgP,int);
+	y0 = va_arg(vaArgP,int);
 	x2 = x0;
 	y2 = y0;
 	
 	while(--nPoint)
 	{
-		//Get new point and draw a line defined by 2 recent point
+		//Get new point and draw a line defined by 2 recent point, the
+		//shared point is drawn by the previous line
 		x1 = x2;
 		y1 = y2;
 		
-		x2 = va_arg(vaArgP,uint8_t);
-		y2 = va_arg(vaArgP,uint8_t);
+		x2 = va_arg(vaArgP,int);
+		y2 = va_arg(vaArgP,int);
 		
-		Oled_DrawLine(x1,y1,x2,y2);
+		Oled_draw_clipped_line(x1, y1, x2, y2, skip);
+		skip = LINE_SKIP_FIRST;
 	}
-	Oled_DrawLine(x0,y0,x2,y2);	//Draw the final line
+	//Draw the final line
+	Oled_draw_clipped_line(x2, y2, x0, y0, LINE_SKIP_FIRST | LINE_SKIP_LAST);
 	
 	va_end(vaArgP);		// End the varargs processing.
 }
 
+/******************************************************************************
+ * Oled_DrawPolygonArray - draw polygon from an array of points
+ * Same as Oled_DrawPolygon, for points computed at runtime. The points may be
+ * outside the screen, the lines are clipped. Each point is drawn once, the
+ * lines do not draw the points they share.
+ *
+ * Parameter:
+ * 	points: points of the polygon, in order (the last point is joined to the
+ * 	first one)
+ * 	nPoint: number of points
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_DrawPolygonArray(const OLED_POINT *points, uint8_t nPoint)
+{
+	//sanity check
+	if (nPoint < 2)
+		return;
+
+	Oled_DrawPolyline(points, nPoint);
+	Oled_draw_clipped_line(points[nPoint - 1].x, points[nPoint - 1].y,
+						   points[0].x, points[0].y, LINE_SKIP_FIRST | LINE_SKIP_LAST);
+}
+
+/******************************************************************************
+ * Oled_DrawPolyline - draw an open polyline from an array of points
+ * Consecutive lines share their joint point, which is drawn only once. The
+ * points may be outside the screen, the lines are clipped, so a chart or an
+ * oscilloscope trace is drawn with a single call.
+ *
+ * Parameter:
+ * 	points: points of the polyline, in order
+ * 	nPoint: number of points
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_DrawPolyline(const OLED_POINT *points, uint8_t nPoint)
+{
+	uint8_t i;
+
+	//sanity check
+	if (!nPoint)
+		return;
+	if (nPoint == 1)
+	{
+		Oled_draw_clipped_line(points[0].x, points[0].y, points[0].x, points[0].y, 0);
+		return;
+	}
+
+	for (i = 1; i < nPoint; i++)
+		Oled_draw_clipped_line(points[i - 1].x, points[i - 1].y, points[i].x, points[i].y,
+							   (i > 1) ? LINE_SKIP_FIRST : 0);
+}
+
 /******************************************************************************
  * Oled_DrawTriangle - draw triangle
  * This is a special case of the draw polygon function
@@ -90,6 +175,11 @@ void Oled_DrawTriangle(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1,
 
 /******************************************************************************
  * Oled_DrawFilledTriangle - Draw filled triangle
+ * The 3 edges are traced once with the same Bresenham steps as
+ * Oled_DrawLine, keeping the upper and lower pixel of every column. Then each
+ * column is filled with a single vertical span, so the filled triangle covers
+ * exactly the pixels of Oled_DrawTriangle and the inside. The time is linear
+ * in the size of the triangle.
  *
  * Parameter:
  * 	(x0,y0)
@@ -101,26 +191,30 @@ void Oled_DrawTriangle(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1,
 void Oled_DrawFilledTriangle(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1,
 							 uint8_t x2, uint8_t y2)
 {
-	uint8_t tmp;
-	
-	//sort accending (x0 < x1 < x2) before call the section 
-	if (x0 > x1)
-	{
-		swap(x0, x1);
-		swap(y0, y1);
-	}
-	if (x0 > x2)
-	{
-		swap(x0, x2);
-		swap(y0, y2);
-	}
-	if (x1 > x2)
+	uint8_t top[OLED_COLUMNSIZE], bottom[OLED_COLUMNSIZE];
+	uint8_t x, xMin, xMax;
+
+	//columns of the triangle
+	xMin = (x0 < x1) ? x0 : x1;
+	xMin = (x2 < xMin) ? x2 : xMin;
+	xMax = (x0 > x1) ? x0 : x1;
+	xMax = (x2 > xMax) ? x2 : xMax;
+	if (xMin >= OLED_COLUMNSIZE)
+		return;
+	if (xMax >= OLED_COLUMNSIZE)
+		xMax = OLED_COLUMNSIZE - 1;
+
+	for (x = xMin; x <= xMax; x++)
 	{
-		swap(x1, x2);
-		swap(y1, y2);
+		top[x] = 0xFF;
+		bottom[x] = 0;
 	}
-	
-	Oled_draw_filled_triangle_section(x0, y0, x1, y1, x2, y2);
+	Oled_trace_edge(x0, y0, x1, y1, top, bottom);
+	Oled_trace_edge(x1, y1, x2, y2, top, bottom);
+	Oled_trace_edge(x2, y2, x0, y0, top, bottom);
+
+	for (x = xMin; x <= xMax; x++)
+		Oled_FillColumn(x, top[x], bottom[x]);
 }
 
  /*****************************************************************************
@@ -145,11 +239,11 @@ void Oled_DrawFilledTriangle(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1,
 		return;
 	
 	va_start(vaArgP,nPoint);	// Start the varargs processing.
-	//Get the first 2 points of the polygon
-	x0 = va_arg(vaArgP,uint8_t);
-	y0 = va_arg(vaArgP,uint8_t);
-	x2 = va_arg(vaArgP,uint8_t);
-	y2 = va_arg(vaArgP,uint8_t);
+	//Get the first 2 points of the polygon (uint8_t arguments are passed as int)
+	x0 = va_arg(vaArgP,int);
+	y0 = va_arg(vaArgP,int);
+	x2 = va_arg(vaArgP,int);
+	y2 = va_arg(vaArgP,int);
 	nPoint -= 2;
 	
 	while(nPoint--)
@@ -159,8 +253,8 @@ void Oled_DrawFilledTriangle(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1,
 		x1 = x2;
 		y1 = y2;
 		
-		x2 = va_arg(vaArgP,uint8_t);
-		y2 = va_arg(vaArgP,uint8_t);
+		x2 = va_arg(vaArgP,int);
+		y2 = va_arg(vaArgP,int);
 		
 		Oled_DrawFilledTriangle(x0,y0,x1,y1,x2,y2);
 	}
@@ -169,167 +263,342 @@ void Oled_DrawFilledTriangle(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1,
  }
 
 /******************************************************************************
- * Oled_draw_filled_triangle_section - Draw filled triangle section
- * This algorithm is inherited from algorithm in Oled_DrawLine function and
- * from Bresenham algorithm.
- * This section has 2 steps:
- * 	1. Fill the area inside line ({x0, y0},{x1, y1}) and line
- * 	({x0, y0},{x2, y2})
- * 	2. Fill the area inside line ({x0, y0},{x2, y2}) and line
- * 	({x1, y1},{x2, y2})
+ * Oled_FillPolygon - draw a filled polygon of any shape
+ * Scanline filler with an edge table and an active edge list. The screen
+ * buffer is made of vertical page bytes, so the scanlines are the columns:
+ * 	1. the edge table holds the non vertical edges sorted by first column
+ * 	2. at each column, the edges starting there enter the active edge list
+ * 	and the finished edges leave it; the list is kept sorted by y
+ * 	3. the spans inside the polygon are filled, each span is written with a
+ * 	page mask per page (Oled_DrawColumn)
+ * 	4. every active edge steps its y-coordinate to the next column
+ * The outline is drawn at the end (with the fill pattern), so the filled
+ * polygon covers the same pixels as its outline. Pixels outside the screen
+ * are clipped.
  *
  * Parameter:
- * 	(x0, y0)
- * 	(x1, y1) : coordinate of the triangle points
- * 	(x2, y2)
+ * 	points: points of the polygon, in order (the last point is joined to the
+ * 	first one)
+ * 	nPoint: number of points (maximum POLYGON_MAX_POINTS)
+ * 	rule  : POLYGON_EVEN_ODD or POLYGON_NONZERO, inside of a self-intersecting
+ * 	polygon
  *
- * Return: none
+ * Return: false if the polygon has more than POLYGON_MAX_POINTS points
+ * (nothing is drawn), true otherwise
  *****************************************************************************/
-static void Oled_draw_filled_triangle_section(uint8_t x0, uint8_t y0,
-						uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2)
+bool Oled_FillPolygon(const OLED_POINT *points, uint8_t nPoint, uint8_t rule)
 {
-	/* TODO: use less variable to save memory resource. Need more optimization */
-    uint8_t tmp,tmpy;
-	uint8_t x, x_, y, y_;
-	uint8_t dx01, dy01, dx02, dy02, dx12, dy12;
-	int8_t err01, err02, err12;
-	int8_t ystep01, ystep02, ystep12;
-    uint8_t x0_ = x0, y0_ = y0, x1_ = x1, y1_ = y1, x2_ = x2, y2_ = y2;
-	bool swapxy01 = false, swapxy02 = false, swapxy12 = false;
-
-    /* algorithm initialization */
-    //line {x0,y0} {x1, y1}
-	dx01 = ( x0 > x1 ) ? (x0-x1) : (x1-x0);
-	dy01 = ( y0 > y1 ) ? (y0-y1) : (y1-y0);
-	if (dy01 > dx01)
-	{
-		swapxy01 = true;
-		swap(dx01,dy01);
-		swap(x1,y1);
-		swap(x0,y0);
-	}
-	if (x1 < x0)
+	POLYGON_EDGE edge[POLYGON_MAX_POINTS], *e;
+	uint8_t order[POLYGON_MAX_POINTS], active[POLYGON_MAX_POINTS];
+	uint8_t nEdge, nActive, next, i, j, k;
+	const OLED_POINT *p0, *p1;
+	int16_t x, xEnd;
+	int32_t dy;
+	int64_t num, quot;
+	int8_t winding;
+
+	//sanity check
+	if (nPoint > POLYGON_MAX_POINTS)
+		return false;
+	if (nPoint < 2)
+		return true;
+
+	//edge table, sorted by first column (insertion sort)
+	nEdge = 0;
+	x = 32767;
+	xEnd = -32768;
+	for (i = 0; i < nPoint; i++)
 	{
-		swap(x1,x0);
-		swap(y1,y0);
+		p0 = &points[i];
+		p1 = &points[(i + 1 < nPoint) ? i + 1 : 0];
+		if (p0->x == p1->x)		//vertical edges are only drawn by the outline
+			continue;
+
+		e = &edge[nEdge];
+		e->dir = (p0->x < p1->x) ? 1 : -1;
+		if (e->dir < 0)
+		{
+			p0 = p1;
+			p1 = &points[i];
+		}
+		e->xa = p0->x;
+		e->xb = p1->x;
+		e->dx = p1->x - p0->x;
+		dy = (int32_t)p1->y - p0->y;
+		e->q = dy / e->dx;
+		if (e->q * e->dx > dy)	//round down
+			e->q--;
+		e->r = dy - e->q * e->dx;
+		e->y = p0->y;
+		e->rem = 0;
+
+		for (j = nEdge; (j > 0) && (edge[order[j - 1]].xa > e->xa); j--)
+			order[j] = order[j - 1];
+		order[j] = nEdge++;
+
+		if (e->xa < x)
+			x = e->xa;
+		if (e->xb > xEnd)
+			xEnd = e->xb;
 	}
-	err01 = dx01 >> 1;
-	ystep01 = (y1 > y0) ?  1 : -1;
-	y = y0;
-
-    //line {x0,y0} {x2, y2}
-    dx02 = ( x0_ > x2 ) ? (x0_-x2) : (x2-x0_);
-	dy02 = ( y0_ > y2 ) ? (y0_-y2) : (y2-y0_);
-	if (dy02 > dx02)
+
+	if (x < 0)
+		x = 0;
+	if (xEnd > OLED_COLUMNSIZE)
+		xEnd = OLED_COLUMNSIZE;
+
+	nActive = 0;
+	next = 0;
+	for (; x < xEnd; x++)
 	{
-		swapxy02 = true;
-		swap(dx02,dy02);
-		swap(x2,y2);
-		swap(x0_,y0_);
+		//the edges starting at this column (or before the screen) become active
+		for (; (next < nEdge) && (edge[order[next]].xa <= x); next++)
+		{
+			e = &edge[order[next]];
+			if (e->xb <= x)
+				continue;
+			if (e->xa < x)	//clipped edge: y at the first column of the screen
+			{
+				num = (int64_t)(x - e->xa) * (e->q * e->dx + e->r);
+				quot = num / e->dx;
+				if (quot * e->dx > num)
+					quot--;
+				e->y += (int32_t)quot;
+				e->rem = (uint16_t)(num - quot * e->dx);
+			}
+			active[nActive++] = order[next];
+		}
+
+		//remove the finished edges, sort the others by y (insertion sort,
+		//the list is almost sorted since the previous column)
+		for (i = j = 0; i < nActive; i++)
+		{
+			if (edge[active[i]].xb <= x)
+				continue;
+			e = &edge[active[i]];
+			for (k = j; (k > 0) && Oled_edge_below(&edge[active[k - 1]], e); k--)
+				active[k] = active[k - 1];
+			active[k] = e - edge;
+			j++;
+		}
+		nActive = j;
+
+		//fill the spans inside the polygon
+		winding = 0;
+		for (i = 0; i < nActive; i++)
+		{
+			e = &edge[active[i]];
+			if (rule == POLYGON_NONZERO)
+			{
+				if (winding && !(winding + e->dir))	//leaving the polygon
+					Oled_fill_span(x, &edge[active[j]], e);
+				else if (!winding)					//entering the polygon
+					j = i;
+				winding += e->dir;
+			}
+			else if (i & 1)
+				Oled_fill_span(x, &edge[active[i - 1]], e);
+		}
+
+		//step to the next column
+		for (i = 0; i < nActive; i++)
+		{
+			e = &edge[active[i]];
+			e->y += e->q;
+			if (e->rem >= e->dx - e->r)
+			{
+				e->rem -= e->dx - e->r;
+				e->y++;
+			}
+			else
+				e->rem += e->r;
+		}
 	}
-	if (x2 < x0_)
+
+	//outline
+	for (i = 0; i < nPoint; i++)
 	{
-		swap(x2,x0_);
-		swap(y2,y0_);
+		p0 = &points[i];
+		p1 = &points[(i + 1 < nPoint) ? i + 1 : 0];
+		Oled_draw_clipped_line(p0->x, p0->y, p1->x, p1->y, LINE_FILL);
 	}
-	ystep02 = (y2 > y0_) ?  1 : -1;
+	return true;
+}
 
-    //line {x1,y1} {x2, y2}	
-    dx12 = (x1_ > x2_) ? (x1_-x2_) : (x2_-x1_);
-	dy12 = (y1_ > y2_) ? (y1_-y2_) : (y2_-y1_);
-	if (dy12 > dx12)
+/******************************************************************************
+ * Oled_trace_edge - trace an edge of a filled triangle
+ * The pixels are the ones of Oled_DrawLine, they only update the upper and
+ * lower pixel of their column.
+ *
+ * Parameter:
+ * 	(x1, y1): position of the first point
+ * 	(x2, y2): position of the second point
+ * 	top	  : upper pixel of each column
+ * 	bottom: lower pixel of each column
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_trace_edge(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2,
+							uint8_t *top, uint8_t *bottom)
+{
+	uint8_t tmp;
+	uint8_t px, py, dx, dy;
+	int16_t err;
+	int8_t ystep;
+	uint16_t x;
+	uint8_t y;
+	bool swapxy = false;
+
+	dx = (x1 > x2) ? (x1 - x2) : (x2 - x1);
+	dy = (y1 > y2) ? (y1 - y2) : (y2 - y1);
+
+	if (dy > dx)
 	{
-		swapxy12 = true;
-		swap(dx12,dy12);
-		swap(x2_,y2_);
-		swap(x1_,y1_);
+		swapxy = true;
+		swap(dx, dy);
+		swap(x1, y1);
+		swap(x2, y2);
 	}
-	if (x2_ < x1_)
+
+	if (x1 > x2)
 	{
-		swap(x2_,x1_);
-		swap(y2_,y1_);
+		swap(x1, x2);
+		swap(y1, y2);
 	}
-	err12 = dx12 >> 1;
-	ystep12 = (y2_ > y1_) ?  1 : -1;
 
-    /* scan from x0 to x1 and draw vertical lines inside 
-    /line ({x0, y0},{x1,y1}) and  ({x0, y0}, {x2, y2}) */
-	for (x = x0; x <= x1; x++)
+	err = dx >> 1;
+	ystep = (y2 > y1) ? 1 : -1;
+	y = y1;
+	for (x = x1; x <= x2; x++)
 	{
-		if (!dy01 && swapxy01)	//save time when drawing square triangle
+		px = swapxy ? y : (uint8_t)x;
+		py = swapxy ? (uint8_t)x : y;
+		if (px < OLED_COLUMNSIZE)
 		{
-			x_ = x0_;
-			y_=y0_;
-			break;
+			if (py < top[px])
+				top[px] = py;
+			if (py > bottom[px])
+				bottom[px] = py;
 		}
-
-        x0 = swapxy01 ? y : x;	//x0 store the current x-coordinate of the line ({x0, y0},{x1,y1})
-		y_ = y0_;
-		err02 = dx02 >> 1;
-        for (x_= x0_;x_ <= x2;x_++)	//the x-coordinate in 2 loops can go in the same or reverse direction
-        {
-        	tmp = swapxy02 ? y_ : x_;//tmp store the current x-coordinate of the line ({x0, y0},{x2,y2})
-	        if (x0 == tmp)	//condition to draw a vertical line
-	        {
-		        y0 = swapxy01 ? x : y;//y0 store the current y-coordinate of the line ({x0, y0},{x1,y1})
-	            tmpy = swapxy02 ? x_ : y_;//tmpy store the current x-coordinate of the line ({x0, y0},{x2,y2})
-	            Oled_DrawVLine(x0, (tmpy > y0) ? y0 : tmpy,
-	            		(tmpy > y0) ? tmpy-y0 : y0-tmpy);	//get the length of the line
-	            break;	//escape the loop if the line had been drawn
-	        }
-            err02 -= (int8_t)dy02;
-            if ( err02 < 0 ) 
-            {
-              y_ += (uint8_t)ystep02;
-              err02 += (uint8_t)dx02;
-            }
-        }
-        //update for next step
-		err01 -= (int8_t)dy01;
-		if ( err01 < 0 ) 
+		err -= dy;
+		if (err < 0)
 		{
-		  y += (uint8_t)ystep01;
-		  err01 += (uint8_t)dx01;
+			y += (uint8_t)ystep;
+			err += dx;
 		}
 	}
+}
+
+/******************************************************************************
+ * Oled_edge_below - compare the y-coordinates of 2 active edges
+ * The exact positions (y + rem/dx) are compared, without division.
+ *
+ * Parameter:
+ * 	e1, e2: the edges
+ *
+ * Return: true if e1 is below e2 at the current column
+ *****************************************************************************/
+static bool Oled_edge_below(const POLYGON_EDGE *e1, const POLYGON_EDGE *e2)
+{
+	if (e1->y != e2->y)
+		return e1->y > e2->y;
+	return (uint32_t)e1->rem * e2->dx > (uint32_t)e2->rem * e1->dx;
+}
 
-    /* scan from x0 to x1 and draw vertical lines inside 
-    line ({x1, y1},{x2,y2}) and  ({x0, y0}, {x2, y2}) */
-    y = y1_;
-    x0_ = x_;
-    y0_ = y_;
-	for (x = x1_; x <= x2_; x++)
+/******************************************************************************
+ * Oled_fill_span - fill the pixels of a column between 2 edges
+ * The pixels whose center is between the edges (inclusive) are filled and
+ * clipped to the screen.
+ *
+ * Parameter:
+ * 	x	  : the column
+ * 	top	  : upper edge
+ * 	bottom: lower edge
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_fill_span(int16_t x, const POLYGON_EDGE *top, const POLYGON_EDGE *bottom)
+{
+	//top rounded up, bottom rounded down
+	Oled_FillColumn(x, top->y + (top->rem ? 1 : 0), bottom->y);
+}
+
+/******************************************************************************
+ * Oled_draw_clipped_line - draw a line which may be partly outside the screen
+ * Same pixels as Oled_DrawLine (Bresenham), but only the part of the line
+ * inside the screen is walked: the Bresenham error of the first visible
+ * column (or row) is computed directly.
+ *
+ * Parameter:
+ * 	(x1, y1): position of the first point
+ * 	(x2, y2): position of the second point
+ * 	skip	: LINE_SKIP_FIRST and/or LINE_SKIP_LAST to leave out (x1, y1)
+ * 	and/or (x2, y2), LINE_FILL to draw the pixels with the fill pattern
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_draw_clipped_line(int16_t x1, int16_t y1, int16_t x2, int16_t y2,
+								   uint8_t skip)
+{
+	int32_t tmp, x, y, dx, dy, err, k, kEnd, m, lo, hi, kSkip1, kSkip2;
+	int8_t ystep;
+	bool swapxy = false;
+
+	dx = (x1 > x2) ? (int32_t)x1 - x2 : (int32_t)x2 - x1;
+	dy = (y1 > y2) ? (int32_t)y1 - y2 : (int32_t)y2 - y1;
+
+	if (dy > dx)
+	{
+		swapxy = true;
+		swap(dx, dy);
+		swap(x1, y1);
+		swap(x2, y2);
+	}
+
+	//steps of the skipped end points
+	kSkip1 = (skip & LINE_SKIP_FIRST) ? 0 : -1;
+	kSkip2 = (skip & LINE_SKIP_LAST) ? dx : -1;
+	if (x1 > x2)
+	{
+		swap(x1, x2);
+		swap(y1, y2);
+		kSkip1 = (kSkip1 < 0) ? -1 : dx - kSkip1;
+		kSkip2 = (kSkip2 < 0) ? -1 : dx - kSkip2;
+	}
+	ystep = (y2 > y1) ? 1 : -1;
+
+	//steps of the line inside the screen along the major axis
+	hi = (swapxy ? OLED_HEIGHT : OLED_COLUMNSIZE) - 1;
+	k = (x1 < 0) ? -x1 : 0;
+	kEnd = (x2 > hi) ? hi - x1 : dx;
+	if (k > kEnd)
+		return;
+
+	//Bresenham state after k steps: m steps of the minor axis so far
+	err = dx >> 1;
+	m = 0;
+	if ((int64_t)k * dy > err)
+		m = (int32_t)(((int64_t)k * dy - err + dx - 1) / dx);
+	err = (int32_t)(err - (int64_t)k * dy + (int64_t)m * dx);
+	y = y1 + ystep * m;
+
+	lo = 0;
+	hi = (swapxy ? OLED_COLUMNSIZE : OLED_HEIGHT) - 1;
+	for (x = x1 + k; k <= kEnd; k++, x++)
 	{
-		if (!dy12 && swapxy12)	//save time when drawing square triangle
-			break;
-
-        x0 = swapxy12 ? y : x;	//x0 store the current x-coordinate of the line ({x1, y1},{x2,y2})
-        y_ = y0_;
-        err02 = dx02 >> 1;
-        for (x_ = x0_; x_ <= x2;x_++)	//the x-coordinate in 2 loops can go in the same or reverse direction
-        {
-    		tmp = swapxy02 ? y_ : x_;//tmp store the current x-coordinate of the line ({x0, y0},{x2,y2})
-	        if (x0 == tmp)	//condition to draw a vertical line
-	        {
-		        y0 = swapxy12 ? x : y;//y0 store the current y-coordinate of the line ({x1, y1},{x2,y2})
-	            tmpy = swapxy02 ? x_ : y_;//tmpy store the current x-coordinate of the line ({x0, y0},{x2,y2})
-	            Oled_DrawVLine(x0, (tmpy > y0) ? y0 : tmpy,
-	            		(tmpy > y0) ? tmpy-y0 : y0-tmpy);	//get the length of the line
-	            break;	//escape the loop if the line had been drawn
-	        }
-            err02 -= (int8_t)dy02;
-            if ( err02 < 0 ) 
-            {
-              y_ += (uint8_t)ystep02;
-              err02 += (uint8_t)dx02;
-            }
-        }
-        //update for next step
-		err12 -= (int8_t)dy12;
-		if ( err12 < 0 ) 
+		if ((y >= lo) && (y <= hi) && (k != kSkip1) && (k != kSkip2))
+		{
+			if (skip & LINE_FILL)	//bit 0 of the fill byte is the pixel
+				swapxy ? Oled_DrawPixel(y, x, Oled_FillByte(y, x) & 1) :
+						 Oled_DrawPixel(x, y, Oled_FillByte(x, y) & 1);
+			else
+				swapxy ? Oled_DrawPixel(y, x, 1) : Oled_DrawPixel(x, y, 1);
+		}
+		err -= dy;
+		if (err < 0)
 		{
-		  y += (uint8_t)ystep12;
-		  err12 += (uint8_t)dx12;
+			y += ystep;
+			err += dx;
 		}
 	}
 }
@@ -74,6 +74,9 @@ void Oled_DrawVLine(uint8_t x, uint8_t y, uint8_t h)
 
 /******************************************************************************
  * Oled_DrawFrame - Draw a rectangle frame
+ * The frame is drawn with the style set by Oled_SetLineStyle. The edges of
+ * a wide frame are centered on the 1-pixel frame and stretched by half the
+ * width, so the corners are square.
  *
  * Parameter:
  * 	(x, y): upper left position
@@ -88,6 +91,30 @@ void Oled_DrawVLine(uint8_t x, uint8_t y, uint8_t h)
 void Oled_DrawFrame(uint8_t x, uint8_t y, uint8_t w, uint8_t h)
 {
 	uint8_t xtmp = x;
+	uint8_t width = Oled_GetLineWidth();
+	int16_t xa, xb, ya, yb;
+
+	if (!w || !h)
+		return;
+
+	if (width != 1 || Oled_GetLinePattern() != LINE_PATTERN_SOLID)
+	{
+		//edges clockwise, stretched over the corners (clipped to the screen)
+		xa = x - (width - 1) / 2;
+		xb = x + w - 1 + width / 2;
+		ya = y - (width - 1) / 2;
+		yb = y + h - 1 + width / 2;
+		xa = (xa < 0) ? 0 : xa;
+		ya = (ya < 0) ? 0 : ya;
+		xb = (xb >= OLED_COLUMNSIZE) ? OLED_COLUMNSIZE - 1 : xb;
+		yb = (yb >= OLED_HEIGHT) ? OLED_HEIGHT - 1 : yb;
+		Oled_DrawLine(xa, y, xb, y);
+		Oled_DrawLine(x + w - 1, ya, x + w - 1, yb);
+		Oled_DrawLine(xb, y + h - 1, xa, y + h - 1);
+		Oled_DrawLine(x, yb, x, ya);
+		return;
+	}
+
 	//Draw 4 lines
 	Oled_DrawHLine(x, y, w);
 	Oled_DrawVLine(x, y, h);
@@ -101,6 +128,7 @@ void Oled_DrawFrame(uint8_t x, uint8_t y, uint8_t w, uint8_t h)
 
 /******************************************************************************
  * Oled_DrawRFrame - Draw a rectangle frame with rounded corner
+ * The frame is drawn with the style set by Oled_SetLineStyle.
  *
  * Parameter:
  * 	(x, y): upper left position
@@ -137,6 +165,21 @@ void Oled_DrawRFrame(uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint8_t r)
 	yu++;
 	h--;
 	w--;
+	if (Oled_GetLineWidth() != 1 || Oled_GetLinePattern() != LINE_PATTERN_SOLID)
+	{
+		//styled edges between the corner arcs
+		if (ww)
+		{
+			Oled_DrawLine(xl, y, xl + ww - 1, y);
+			Oled_DrawLine(xl, y + h, xl + ww - 1, y + h);
+		}
+		if (hh)
+		{
+			Oled_DrawLine(x, yu, x, yu + hh - 1);
+			Oled_DrawLine(x + w, yu, x + w, yu + hh - 1);
+		}
+		return;
+	}
 	//draw 4 lines
 	Oled_DrawHLine(xl, y, ww);
 	Oled_DrawHLine(xl, y+h, ww);
@@ -146,6 +189,8 @@ void Oled_DrawRFrame(uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint8_t r)
 
 /******************************************************************************
  * Oled_DrawBox - Draw a filled rectangle
+ * Each column is filled with one masked write per page byte, with the
+ * pattern set by Oled_SetFillPattern.
  *
  * Parameter:
  * 	(x, y): upper left position
@@ -159,16 +204,23 @@ void Oled_DrawRFrame(uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint8_t r)
  *****************************************************************************/
 void Oled_DrawBox(uint8_t x, uint8_t y, uint8_t w, uint8_t h)
 {
+	if (!h)
+		return;
+
 	do
-	{ 
-		Oled_DrawVLine(x, y, h);
+	{
+		Oled_FillColumn(x, y, (int16_t)y + h - 1);
 		x++;
 		w--;
-	} while(w);
+	} while(w && x < OLED_COLUMNSIZE);
 }
 
 /******************************************************************************
  * Oled_DrawRBox - Draw a filled rectangle with rounded corner
+ * The corner arc is walked once to get how far each corner column reaches
+ * beyond the corner centers; then every column of the box is filled once,
+ * from its top to its bottom, with one masked write per page byte (pattern
+ * set by Oled_SetFillPattern).
  *
  * Parameter:
  * 	(x, y): upper left position
@@ -183,32 +235,74 @@ void Oled_DrawBox(uint8_t x, uint8_t y, uint8_t w, uint8_t h)
  *****************************************************************************/
 void Oled_DrawRBox(uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint8_t r)
 {
-	uint8_t xl, yu;
-	uint8_t yl, xr;
-	uint8_t ww, hh;
+	uint8_t ext[OLED_COLUMNSIZE];	//extent of the corner columns
+	int16_t xl, yu;
+	int16_t yl, xr;
+	int16_t col, top, bottom;
+	int16_t f, ddF_x, ddF_y;
+	uint8_t cx, cy;
 
+	if (!w || !h || r >= OLED_COLUMNSIZE)
+		return;
+
+	//corner disc centers
 	xl = x+r;
 	yu = y+r;
 
-	xr = x+w-r-1;
+	xr = (int16_t)x+w-r-1;
 
-	yl = y+h-r-1;
-	//Draw 4 discs at 4 corners
-	Oled_DrawDisc(xl, yu, r, DRAW_UPPER_LEFT);
-	Oled_DrawDisc(xr, yu, r, DRAW_UPPER_RIGHT);
-	Oled_DrawDisc(xl, yl, r, DRAW_LOWER_LEFT);
-	Oled_DrawDisc(xr, yl, r, DRAW_LOWER_RIGHT);
+	yl = (int16_t)y+h-r-1;
 
-	ww = w-((r << 1)+2);
-	hh = h-((r << 1)+2);
+	//walk one octant of the corner circle, each point gives 2 column extents
+	for (cx = 0; cx <= r; cx++)
+		ext[cx] = 0;
+	f = 1 - r;
+	ddF_x = 1;
+	ddF_y = -2 * r;
+	cx = 0;
+	cy = r;
+	while (1)
+	{
+		if (ext[cx] < cy)
+			ext[cx] = cy;
+		if (ext[cy] < cx)
+			ext[cy] = cx;
+		if (cx >= cy)
+			break;
+		if (f >= 0)
+		{
+			cy--;
+			ddF_y += 2;
+			f += ddF_y;
+		}
+		cx++;
+		ddF_x += 2;
+		f += ddF_x;
+	}
 
-	xl++;
-	yu++;
-	h--;
-	//fill the box
-	Oled_DrawBox(xl, y, ww, r+1);
-	Oled_DrawBox(xl, yl, ww, r+1);
-	Oled_DrawBox(x, yu, w, hh);
+	//fill each column once
+	for (col = x; col < x + w && col < OLED_COLUMNSIZE; col++)
+	{
+		if (col < xl)
+		{
+			top = yu - ext[xl - col];
+			bottom = yl + ext[xl - col];
+		}
+		else if (col > xr)
+		{
+			top = yu - ext[col - xr];
+			bottom = yl + ext[col - xr];
+		}
+		else
+		{
+			top = y;
+			bottom = (int16_t)y + h - 1;
+		}
+
+		if (top < y)
+			top = y;
+		Oled_FillColumn(col, top, bottom);
+	}
 }
 
 /* End of Oled_rect.c */
@@ -0,0 +1,394 @@
+/*
+ * Oled_sprite.c - Sprites over a background with automatic update areas
+ * Oled Graphics library
+ *
+ * A scene is a background image and a list of sprites sorted by z. When
+ * sprites move, change image or are hidden, Oled_SceneUpdate rebuilds only
+ * the page bytes below their old and new positions: the background is copied
+ * back, every sprite crossing the area is drawn over it in z order (bitmap
+ * bytes shifted to the row, masked by the sprite mask) and the area is sent
+ * with Oled_UpdateScreen. The rest of the screen is not transmitted.
+ *
+ * This library is use for Tiva Arm Cotex M4
+ * Device: OLED 1.3", 128x64 dot matrix panel
+ * Communication: SPI interface
+ * Driver: SH1106
+ *
+ * Revision: 2.02
+ * Author: QUANG
+ */
+
+#include "../Oled.h"
+
+/*************************Private function prototypes*************************/
+static bool Oled_sprite_area(const OLED_SPRITE *sprite, OLED_RECT *area);
+static void Oled_area_add(OLED_RECT *areas, uint8_t *n, const OLED_RECT *area);
+static bool Oled_area_overlap(const OLED_RECT *a, const OLED_RECT *b);
+static void Oled_area_merge(OLED_RECT *a, const OLED_RECT *b);
+static void Oled_scene_compose(OLED_SCENE *scene, const OLED_RECT *area);
+static void Oled_sprite_draw(const OLED_SPRITE *sprite, const OLED_RECT *area);
+
+/****************************Function definitions*****************************/
+
+/******************************************************************************
+ * Oled_SceneInit - Initialize an empty scene
+ * Nothing is drawn, use Oled_SceneRedraw to draw the whole scene.
+ *
+ * Parameter:
+ * 	scene	  : the scene
+ * 	background: full screen image (128x64, Oled_DrawBitmap layout: 1024
+ * 				bytes) or 0 for a cleared background
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_SceneInit(OLED_SCENE *scene, const uint8_t *background)
+{
+	scene->background = background;
+	scene->first = 0;
+}
+
+/******************************************************************************
+ * Oled_SceneAdd - add a sprite to a scene
+ * The sprite is drawn by the next Oled_SceneUpdate (if visible). A sprite
+ * belongs to one scene only.
+ *
+ * Parameter:
+ * 	scene : the scene
+ * 	sprite: the sprite, initialized by Oled_SpriteInit
+ * 	z	  : drawing order, higher z on top (same z: added last on top)
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_SceneAdd(OLED_SCENE *scene, OLED_SPRITE *sprite, uint8_t z)
+{
+	OLED_SPRITE **link = &scene->first;
+
+	while (*link && (*link)->z <= z)
+		link = &(*link)->next;
+
+	sprite->z = z;
+	sprite->next = *link;
+	sprite->changed = true;
+	*link = sprite;
+}
+
+/******************************************************************************
+ * Oled_SceneRedraw - draw the whole scene and send the whole screen
+ *
+ * Parameter:
+ * 	scene: the scene
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_SceneRedraw(OLED_SCENE *scene)
+{
+	OLED_RECT all = {0, 0, OLED_COLUMNSIZE, OLED_PAGESIZE};
+	OLED_SPRITE *sprite;
+
+	for (sprite = scene->first; sprite; sprite = sprite->next)
+	{
+		sprite->drawn = sprite->visible && Oled_sprite_area(sprite, &sprite->area);
+		sprite->changed = false;
+	}
+	Oled_scene_compose(scene, &all);
+}
+
+/******************************************************************************
+ * Oled_SceneUpdate - redraw and send the changed parts of a scene
+ * The areas are the page bytes below the old and the new position of every
+ * changed sprite, overlapping areas are merged (at most SPRITE_MAX_AREAS
+ * areas, more are merged into the last one). Each area is rebuilt from the
+ * background and the sprites crossing it, then sent to the Oled.
+ *
+ * Parameter:
+ * 	scene: the scene
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_SceneUpdate(OLED_SCENE *scene)
+{
+	OLED_RECT areas[SPRITE_MAX_AREAS];
+	OLED_SPRITE *sprite;
+	uint8_t n = 0, i;
+
+	for (sprite = scene->first; sprite; sprite = sprite->next)
+	{
+		if (!sprite->changed)
+			continue;
+		if (sprite->drawn)
+			Oled_area_add(areas, &n, &sprite->area);
+		sprite->drawn = sprite->visible && Oled_sprite_area(sprite, &sprite->area);
+		if (sprite->drawn)
+			Oled_area_add(areas, &n, &sprite->area);
+		sprite->changed = false;
+	}
+
+	for (i = 0; i < n; i++)
+		Oled_scene_compose(scene, &areas[i]);
+}
+
+/******************************************************************************
+ * Oled_SpriteInit - Initialize a sprite
+ * The sprite is visible at (0, 0), use Oled_SceneAdd to put it in a scene.
+ *
+ * Parameter:
+ * 	sprite: the sprite
+ * 	bitmap: image (Oled_DrawBitmap layout)
+ * 	mask  : opaque pixels (same layout) or 0: the whole rectangle is opaque
+ * 	w	  : width in pixel
+ * 	h	  : height in pixel
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_SpriteInit(OLED_SPRITE *sprite, const uint8_t *bitmap, const uint8_t *mask,
+					 uint8_t w, uint8_t h)
+{
+	sprite->bitmap = bitmap;
+	sprite->mask = mask;
+	sprite->x = 0;
+	sprite->y = 0;
+	sprite->w = w;
+	sprite->h = h;
+	sprite->z = 0;
+	sprite->visible = true;
+	sprite->changed = true;
+	sprite->drawn = false;
+	sprite->next = 0;
+}
+
+/******************************************************************************
+ * Oled_SpriteMove - move a sprite
+ *
+ * Parameter:
+ * 	sprite: the sprite
+ * 	(x, y): upper left position (may be outside the screen)
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_SpriteMove(OLED_SPRITE *sprite, int16_t x, int16_t y)
+{
+	if (x == sprite->x && y == sprite->y)
+		return;
+	sprite->x = x;
+	sprite->y = y;
+	sprite->changed = true;
+}
+
+/******************************************************************************
+ * Oled_SpriteSetImage - change the image of a sprite (animation frame)
+ * The sprite is redrawn even if the pointers did not change, so an image
+ * updated in RAM is drawn again.
+ *
+ * Parameter:
+ * 	sprite: the sprite
+ * 	bitmap: image, same size as the sprite
+ * 	mask  : opaque pixels or 0
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_SpriteSetImage(OLED_SPRITE *sprite, const uint8_t *bitmap, const uint8_t *mask)
+{
+	sprite->bitmap = bitmap;
+	sprite->mask = mask;
+	sprite->changed = true;
+}
+
+/******************************************************************************
+ * Oled_SpriteShow - show or hide a sprite
+ *
+ * Parameter:
+ * 	sprite : the sprite
+ * 	visible: true to show the sprite, false to hide it
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_SpriteShow(OLED_SPRITE *sprite, bool visible)
+{
+	if (visible == sprite->visible)
+		return;
+	sprite->visible = visible;
+	sprite->changed = true;
+}
+
+/******************************************************************************
+ * Oled_sprite_area - page bytes covered by a sprite
+ *
+ * Parameter:
+ * 	sprite: the sprite
+ * 	area  : returned area: x, first page (y), columns (w) and pages (h)
+ *
+ * Return: false if the sprite is outside the screen
+ *****************************************************************************/
+static bool Oled_sprite_area(const OLED_SPRITE *sprite, OLED_RECT *area)
+{
+	int16_t x0 = sprite->x, x1 = sprite->x + sprite->w - 1;
+	int16_t y0 = sprite->y, y1 = sprite->y + sprite->h - 1;
+
+	if (!sprite->w || !sprite->h || x1 < 0 || x0 >= OLED_COLUMNSIZE ||
+		y1 < 0 || y0 >= OLED_HEIGHT)
+		return false;
+
+	x0 = (x0 < 0) ? 0 : x0;
+	x1 = (x1 >= OLED_COLUMNSIZE) ? OLED_COLUMNSIZE - 1 : x1;
+	y0 = (y0 < 0) ? 0 : y0;
+	y1 = (y1 >= OLED_HEIGHT) ? OLED_HEIGHT - 1 : y1;
+	area->x = x0;
+	area->w = x1 - x0 + 1;
+	area->y = y0 / 8;
+	area->h = y1 / 8 - y0 / 8 + 1;
+	return true;
+}
+
+/******************************************************************************
+ * Oled_area_add - add an area to the update list
+ * The area is merged with the areas it overlaps (and the merged area again,
+ * until no area overlaps), so no page byte is sent twice.
+ *
+ * Parameter:
+ * 	areas: update list (SPRITE_MAX_AREAS areas)
+ * 	n	 : number of areas in the list
+ * 	area : area to add (x, page, columns, pages)
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_area_add(OLED_RECT *areas, uint8_t *n, const OLED_RECT *area)
+{
+	OLED_RECT cur = *area;
+	uint8_t i = 0;
+
+	while (i < *n)
+	{
+		if (Oled_area_overlap(&areas[i], &cur))
+		{
+			//take it out of the list and add the union
+			Oled_area_merge(&cur, &areas[i]);
+			areas[i] = areas[--(*n)];
+			i = 0;
+		}
+		else
+			i++;
+	}
+
+	if (*n < SPRITE_MAX_AREAS)
+		areas[(*n)++] = cur;
+	else
+		Oled_area_merge(&areas[*n - 1], &cur);
+}
+
+/******************************************************************************
+ * Oled_area_overlap - check if 2 areas share a page byte
+ *
+ * Parameter:
+ * 	a, b: the areas (x, page, columns, pages)
+ *
+ * Return: true if they overlap
+ *****************************************************************************/
+static bool Oled_area_overlap(const OLED_RECT *a, const OLED_RECT *b)
+{
+	return (a->x < b->x + b->w) && (b->x < a->x + a->w) &&
+		   (a->y < b->y + b->h) && (b->y < a->y + a->h);
+}
+
+/******************************************************************************
+ * Oled_area_merge - grow an area to the bounding box of 2 areas
+ *
+ * Parameter:
+ * 	a: the area to grow
+ * 	b: the other area
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_area_merge(OLED_RECT *a, const OLED_RECT *b)
+{
+	uint8_t x1 = (a->x + a->w > b->x + b->w) ? a->x + a->w : b->x + b->w;
+	uint8_t y1 = (a->y + a->h > b->y + b->h) ? a->y + a->h : b->y + b->h;
+
+	a->x = (b->x < a->x) ? b->x : a->x;
+	a->y = (b->y < a->y) ? b->y : a->y;
+	a->w = x1 - a->x;
+	a->h = y1 - a->y;
+}
+
+/******************************************************************************
+ * Oled_scene_compose - rebuild an area of the scene and send it
+ *
+ * Parameter:
+ * 	scene: the scene
+ * 	area : the area (x, page, columns, pages)
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_scene_compose(OLED_SCENE *scene, const OLED_RECT *area)
+{
+	uint8_t *buffer = Oled_GetBuffer();
+	const OLED_SPRITE *sprite;
+	uint8_t x, page;
+
+	//background
+	for (x = area->x; x < area->x + area->w; x++)
+	{
+		for (page = area->y; page < area->y + area->h; page++)
+			buffer[x * OLED_PAGESIZE + page] =
+				scene->background ? scene->background[page * OLED_COLUMNSIZE + x] : 0;
+	}
+
+	//sprites crossing the area, lowest first
+	for (sprite = scene->first; sprite; sprite = sprite->next)
+	{
+		if (sprite->drawn && Oled_area_overlap(&sprite->area, area))
+			Oled_sprite_draw(sprite, area);
+	}
+
+	Oled_UpdateScreen(area->x, area->y * 8, area->w, area->h * 8);
+}
+
+/******************************************************************************
+ * Oled_sprite_draw - draw the part of a sprite inside an area
+ * Each bitmap byte is shifted to the sprite row and copied over the 2 page
+ * bytes it falls on (Oled_DrawPageRop); the mask, the sprite height and the
+ * pages of the area select the bits written.
+ *
+ * Parameter:
+ * 	sprite: the sprite
+ * 	area  : the area (x, page, columns, pages)
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_sprite_draw(const OLED_SPRITE *sprite, const OLED_RECT *area)
+{
+	int16_t x0, x1, p0, p1, k0, k1, page, k;
+	int16_t pTop = (sprite->y >= 0) ? sprite->y / 8 : -((7 - sprite->y) / 8);
+	uint8_t shift = sprite->y - pTop * 8;
+	uint8_t nPage = (sprite->h + 7) / 8;
+	uint16_t rows;
+
+	//columns and pages of the sprite inside the area
+	x0 = (sprite->x > area->x) ? sprite->x : area->x;
+	x1 = sprite->x + sprite->w;
+	x1 = (x1 < area->x + area->w) ? x1 : area->x + area->w;
+	p0 = (sprite->area.y > area->y) ? sprite->area.y : area->y;
+	p1 = sprite->area.y + sprite->area.h;
+	p1 = (p1 < area->y + area->h) ? p1 : area->y + area->h;
+
+	//bitmap pages falling on the pages of the area
+	k0 = (p0 - 1 - pTop > 0) ? p0 - 1 - pTop : 0;
+	k1 = (p1 - pTop < nPage) ? p1 - pTop : nPage;
+
+	for (k = k0; k < k1; k++)
+	{
+		//bitmap page k falls on the screen pages page and page+1
+		page = pTop + k;
+		rows = (sprite->h - k * 8 >= 8) ? 0xFF : 0xFF >> (8 - (sprite->h - k * 8));
+		rows <<= shift;
+		if (page < p0)			//pages outside the area
+			rows &= 0xFF00;
+		if (page + 1 >= p1)
+			rows &= 0x00FF;
+
+		Oled_DrawPageRop(x0, page, shift, &sprite->bitmap[k * sprite->w + x0 - sprite->x],
+						 sprite->mask ? &sprite->mask[k * sprite->w + x0 - sprite->x] : 0,
+						 rows, x1 - x0, BITMAP_ROP_COPY);
+	}
+}
+
+/* End of Oled_sprite.c */
@@ -0,0 +1,247 @@
+/*
+ * Oled_textbox.c - Word-wrapped text boxes
+ * Oled Graphics library
+ *
+ * A text box lays out a text once: the text is word-wrapped to the box
+ * width with the widths of its font and the start of every line is cached.
+ * Drawing and scrolling only use the cached line breaks, so a long text is
+ * never measured again until it is changed.
+ *
+ * This library is use for Tiva Arm Cotex M4
+ * Device: OLED 1.3", 128x64 dot matrix panel
+ * Communication: SPI interface
+ * Driver: SH1106
+ *
+ * Revision: 2.02
+ * Author: QUANG
+ */
+
+#include "../Oled.h"
+
+/*************************Private function prototypes*************************/
+static void Oled_textbox_layout(OLED_TEXTBOX *textbox);
+
+/****************************Function definitions*****************************/
+
+/******************************************************************************
+ * Oled_TextBoxInit - Initialize a text box
+ * The box is empty, nothing is drawn.
+ *
+ * Parameter:
+ * 	textbox: the text box
+ * 	box	   : area of the text box
+ * 	font   : font of the text
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_TextBoxInit(OLED_TEXTBOX *textbox, const OLED_RECT *box, FONT_INFO *font)
+{
+	textbox->box = *box;
+	textbox->font = font;
+	textbox->text = "";
+	textbox->lines = 0;
+	textbox->top = 0;
+	textbox->lineStart[0] = 0;
+}
+
+/******************************************************************************
+ * Oled_TextBoxSetText - Set the text of a text box
+ * The text is word-wrapped to the box width: lines are broken after a space,
+ * or before the character which does not fit when a word is wider than the
+ * box, and at every '\n'. The box is scrolled to the first line and drawn.
+ * Only the first TEXTBOX_MAX_LINES lines are kept.
+ *
+ * Parameter:
+ * 	textbox: the text box
+ * 	text   : UTF-8 text. The text is not copied and must stay valid as long
+ * 	as the text box uses it
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_TextBoxSetText(OLED_TEXTBOX *textbox, const char *text)
+{
+	textbox->text = text;
+	textbox->top = 0;
+	Oled_textbox_layout(textbox);
+	Oled_TextBoxDraw(textbox);
+}
+
+/******************************************************************************
+ * Oled_TextBoxScroll - Scroll a text box
+ * The text is not laid out again, only the visible lines are redrawn.
+ *
+ * Parameter:
+ * 	textbox: the text box
+ * 	lines  : number of lines to scroll, positive to scroll down the text
+ * 	(show the next lines), negative to scroll up
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_TextBoxScroll(OLED_TEXTBOX *textbox, int16_t lines)
+{
+	int16_t top = textbox->top + lines;
+	int16_t last = textbox->lines - Oled_TextBoxVisibleLines(textbox);
+
+	if (top > last)
+		top = last;
+	if (top < 0)
+		top = 0;
+	if (top == textbox->top)
+		return;
+
+	textbox->top = top;
+	Oled_TextBoxDraw(textbox);
+}
+
+/******************************************************************************
+ * Oled_TextBoxDraw - Draw a text box
+ * The box is cleared and its visible lines are drawn from the cached line
+ * breaks. Only whole lines are drawn, so the text never goes out of the box.
+ * The box is marked dirty, use Oled_UpdateDirty to send it to the Oled.
+ *
+ * Parameter:
+ * 	textbox: the text box
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_TextBoxDraw(OLED_TEXTBOX *textbox)
+{
+	const OLED_RECT *box = &textbox->box;
+	const char *str, *end;
+	FONT_INFO *font;
+	uint16_t code;
+	uint8_t line, last, x, y, w, height;
+
+	font = Oled_GetFont();
+	Oled_SetFont(textbox->font);
+	height = Oled_FontHeight();
+
+	Oled_Clear(box->x, box->y, box->w, box->h);
+	Oled_MarkDirty(box->x, box->y, box->w, box->h);
+
+	last = textbox->top + Oled_TextBoxVisibleLines(textbox);
+	if (last > textbox->lines)
+		last = textbox->lines;
+
+	y = box->y;
+	for (line = textbox->top; line < last; line++, y += height)
+	{
+		str = textbox->text + textbox->lineStart[line];
+		end = textbox->text + textbox->lineStart[line + 1];
+
+		//spaces and new line at the end of a line are not drawn
+		while ((end > str) && ((end[-1] == ' ') || (end[-1] == '\n')))
+			end--;
+
+		x = 0;
+		while (str < end)
+		{
+			code = Oled_NextChar(&str);
+			w = Oled_CharWidth(code);
+			if (w > box->w - x)	//only a character wider than the box
+				break;
+			Oled_DrawChar(box->x + x, y, code);
+			x += w;
+		}
+	}
+
+	Oled_SetFont(font);
+}
+
+/******************************************************************************
+ * Oled_TextBoxVisibleLines - Get the number of lines a text box can show
+ *
+ * Parameter:
+ * 	textbox: the text box
+ *
+ * Return: number of whole lines which fit in the box height
+ *****************************************************************************/
+uint8_t Oled_TextBoxVisibleLines(const OLED_TEXTBOX *textbox)
+{
+	FONT_INFO *font = Oled_GetFont();
+	uint8_t height;
+
+	Oled_SetFont(textbox->font);
+	height = Oled_FontHeight();
+	Oled_SetFont(font);
+
+	return height ? textbox->box.h / height : 0;
+}
+
+/******************************************************************************
+ * Oled_textbox_layout - compute the line breaks of a text box
+ * The text is measured character by character, once. The width after the
+ * last space is remembered, so breaking a line at that space does not need
+ * to measure the beginning of the next line again.
+ *
+ * Parameter:
+ * 	textbox: the text box
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_textbox_layout(OLED_TEXTBOX *textbox)
+{
+	const char *text = textbox->text;
+	const char *str = text, *cur;
+	FONT_INFO *font;
+	uint16_t code, x, xBreak, brk, width;
+	uint8_t lines = 0, w;
+
+	font = Oled_GetFont();
+	Oled_SetFont(textbox->font);
+	width = textbox->box.w;
+
+	textbox->lineStart[0] = 0;
+	x = 0;
+	brk = 0;		//offset of the word after the last space (0: no space)
+	xBreak = 0;		//x position of that word
+	while (*str && (lines < TEXTBOX_MAX_LINES))
+	{
+		cur = str;
+		code = Oled_NextChar(&str);
+		if (code == '\n')
+		{
+			textbox->lineStart[++lines] = str - text;
+			x = 0;
+			brk = 0;
+			continue;
+		}
+
+		w = Oled_CharWidth(code);
+		if ((code != ' ') && (x + w > width) && (x > 0))
+		{
+			if (brk)	//break after the last space, the word moves down
+			{
+				textbox->lineStart[++lines] = brk;
+				x -= xBreak;
+				brk = 0;
+			}
+			//no space in the line or the word is wider than the box: break the word
+			if ((x + w > width) && (x > 0) && (lines < TEXTBOX_MAX_LINES))
+			{
+				textbox->lineStart[++lines] = cur - text;
+				x = 0;
+			}
+		}
+
+		x += w;
+		if (code == ' ')
+		{
+			brk = str - text;
+			xBreak = x;
+		}
+	}
+
+	//end of the last line
+	if (lines < TEXTBOX_MAX_LINES)
+	{
+		if ((uint16_t)(str - text) > textbox->lineStart[lines])
+			lines++;
+		textbox->lineStart[lines] = str - text;
+	}
+	textbox->lines = lines;
+
+	Oled_SetFont(font);
+}
+
+/* End of Oled_textbox.c */
@@ -0,0 +1,270 @@
+/*
+ * Oled_trig.c - Fixed-point trigonometry (Q15) and 2D affine transforms of
+ * point arrays, no floating point.
+ * Oled Graphics library
+ * This Library is based on Universal 8-bit Graphics Library
+ *
+ * This library is use for Tiva Arm Cotex M4
+ * Device: OLED 1.3", 128x64 dot matrix panel
+ * Communication: SPI interface
+ * Driver: SH1106
+ *
+ * Revision: 2.02
+ * Date: 11/11/2016
+ * Author: QUANG
+ */
+ 
+#include "../Oled.h"
+#include <stdint.h>
+#include "Oled_trigtab.h"
+
+/*************************Private function prototypes*************************/
+static int32_t Oled_q15_mul(int32_t a, int32_t b);
+static void Oled_transform_apply(OLED_TRANSFORM *t, int32_t a, int32_t b, int32_t c, int32_t d);
+
+/****************************Function definitions*****************************/
+
+/******************************************************************************
+ * Oled_Sin - sine of an angle
+ *
+ * Parameter:
+ * 	angle: angle in degrees (any value)
+ *
+ * Return: sin(angle) in Q15 (-32767 to 32767)
+ *****************************************************************************/
+int16_t Oled_Sin(int16_t angle)
+{
+	angle %= 360;
+	if (angle < 0)
+		angle += 360;
+
+	if (angle <= 90)
+		return g_pi16SinTable[angle];
+	if (angle <= 180)
+		return g_pi16SinTable[180 - angle];
+	if (angle <= 270)
+		return -g_pi16SinTable[angle - 180];
+	return -g_pi16SinTable[360 - angle];
+}
+
+/******************************************************************************
+ * Oled_Cos - cosine of an angle
+ *
+ * Parameter:
+ * 	angle: angle in degrees (any value)
+ *
+ * Return: cos(angle) in Q15 (-32767 to 32767)
+ *****************************************************************************/
+int16_t Oled_Cos(int16_t angle)
+{
+	return Oled_Sin((angle % 360) + 90);
+}
+
+/******************************************************************************
+ * Oled_Atan2 - angle of a vector
+ * The vector is folded into the first octant, the ratio of its coordinates
+ * (Q15) is then located in the table of tangent bounds.
+ *
+ * Parameter:
+ * 	(y, x): the vector (x right, y up)
+ *
+ * Return: angle in degrees (0 to 359) rounded to the nearest degree, 0 for
+ * a null vector
+ *****************************************************************************/
+int16_t Oled_Atan2(int32_t y, int32_t x)
+{
+	uint32_t ax, ay, t;
+	uint8_t lo, hi, mid;
+	int16_t angle;
+
+	ax = (x < 0) ? -(uint32_t)x : (uint32_t)x;
+	ay = (y < 0) ? -(uint32_t)y : (uint32_t)y;
+	if (!ax && !ay)
+		return 0;
+
+	//ratio of the small coordinate over the large one, 0 to 1 in Q15
+	t = (ay <= ax) ? (uint32_t)(((uint64_t)ay << 15) / ax) : (uint32_t)(((uint64_t)ax << 15) / ay);
+
+	//number of bounds below t
+	lo = 0;
+	hi = sizeof(g_pui16AtanBound) / sizeof(g_pui16AtanBound[0]);
+	while (lo < hi)
+	{
+		mid = (lo + hi) / 2;
+		if (t >= g_pui16AtanBound[mid])
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	angle = (ay <= ax) ? lo : 90 - lo;
+
+	//back to the right quadrant
+	if (x < 0)
+		angle = 180 - angle;
+	if (y < 0)
+		angle = 360 - angle;
+	return angle % 360;
+}
+
+/******************************************************************************
+ * Oled_Sqrt - integer square root (bit by bit, no division)
+ *
+ * Parameter:
+ * 	n: a number
+ *
+ * Return: floor(sqrt(n))
+ *****************************************************************************/
+uint32_t Oled_Sqrt(uint64_t n)
+{
+	uint64_t root = 0;
+	uint64_t bit = (uint64_t)1 << 62;
+
+	while (bit > n)
+		bit >>= 2;
+	while (bit)
+	{
+		if (n >= root + bit)
+		{
+			n -= root + bit;
+			root = (root >> 1) + bit;
+		}
+		else
+			root >>= 1;
+		bit >>= 2;
+	}
+	return (uint32_t)root;
+}
+
+/******************************************************************************
+ * Oled_TransformIdentity - reset a transform
+ *
+ * Parameter:
+ * 	t: the transform
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_TransformIdentity(OLED_TRANSFORM *t)
+{
+	t->a = OLED_Q15_ONE;
+	t->b = 0;
+	t->c = 0;
+	t->d = OLED_Q15_ONE;
+	t->tx = 0;
+	t->ty = 0;
+}
+
+/******************************************************************************
+ * Oled_TransformRotate - rotate after the current transform
+ * The rotation is counterclockwise on the screen for a positive angle, around
+ * the origin. Rotate the shape before translating it to its place.
+ *
+ * Parameter:
+ * 	t	 : the transform
+ * 	angle: angle in degrees
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_TransformRotate(OLED_TRANSFORM *t, int16_t angle)
+{
+	int32_t s = Oled_Sin(angle);
+	int32_t c = Oled_Cos(angle);
+
+	//screen y goes down: x' = x.cos + y.sin, y' = -x.sin + y.cos
+	Oled_transform_apply(t, c, s, -s, c);
+}
+
+/******************************************************************************
+ * Oled_TransformScale - scale after the current transform
+ *
+ * Parameter:
+ * 	t	  : the transform
+ * 	sx, sy: scale factors in Q15 (OLED_Q15_ONE is 1.0, may be negative)
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_TransformScale(OLED_TRANSFORM *t, int32_t sx, int32_t sy)
+{
+	Oled_transform_apply(t, sx, 0, 0, sy);
+}
+
+/******************************************************************************
+ * Oled_TransformTranslate - translate after the current transform
+ *
+ * Parameter:
+ * 	t	  : the transform
+ * 	dx, dy: offset in pixel
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_TransformTranslate(OLED_TRANSFORM *t, int16_t dx, int16_t dy)
+{
+	t->tx += (int32_t)dx << 15;
+	t->ty += (int32_t)dy << 15;
+}
+
+/******************************************************************************
+ * Oled_TransformPoints - transform a point array
+ * The result can be drawn with Oled_DrawPolygonArray, Oled_DrawPolyline or
+ * Oled_FillPolygon. Coordinates are rounded to the nearest pixel.
+ *
+ * Parameter:
+ * 	t	  : the transform
+ * 	src	  : points to transform
+ * 	dst	  : returned points (may be src)
+ * 	nPoint: number of points
+ *
+ * Return: none
+ *****************************************************************************/
+void Oled_TransformPoints(const OLED_TRANSFORM *t, const OLED_POINT *src, OLED_POINT *dst,
+						  uint8_t nPoint)
+{
+	int64_t x, y;
+
+	while (nPoint--)
+	{
+		x = (int64_t)t->a * src->x + (int64_t)t->b * src->y + t->tx;
+		y = (int64_t)t->c * src->x + (int64_t)t->d * src->y + t->ty;
+		dst->x = (int16_t)((x + 0x4000) >> 15);
+		dst->y = (int16_t)((y + 0x4000) >> 15);
+		src++;
+		dst++;
+	}
+}
+
+/******************************************************************************
+ * Oled_q15_mul - product of 2 Q15 numbers, rounded
+ *
+ * Parameter:
+ * 	a, b: Q15 numbers
+ *
+ * Return: a*b in Q15
+ *****************************************************************************/
+static int32_t Oled_q15_mul(int32_t a, int32_t b)
+{
+	return (int32_t)(((int64_t)a * b + 0x4000) >> 15);
+}
+
+/******************************************************************************
+ * Oled_transform_apply - apply a linear map after a transform
+ * t = M o t, with M = [a b; c d] in Q15. The offset of t is mapped too.
+ *
+ * Parameter:
+ * 	t		  : the transform
+ * 	a, b, c, d: matrix of the linear map
+ *
+ * Return: none
+ *****************************************************************************/
+static void Oled_transform_apply(OLED_TRANSFORM *t, int32_t a, int32_t b, int32_t c, int32_t d)
+{
+	OLED_TRANSFORM r;
+
+	r.a = Oled_q15_mul(a, t->a) + Oled_q15_mul(b, t->c);
+	r.b = Oled_q15_mul(a, t->b) + Oled_q15_mul(b, t->d);
+	r.c = Oled_q15_mul(c, t->a) + Oled_q15_mul(d, t->c);
+	r.d = Oled_q15_mul(c, t->b) + Oled_q15_mul(d, t->d);
+	r.tx = Oled_q15_mul(a, t->tx) + Oled_q15_mul(b, t->ty);
+	r.ty = Oled_q15_mul(c, t->tx) + Oled_q15_mul(d, t->ty);
+	*t = r;
+}
+
+ /* End of Oled_trig.c */
@@ -0,0 +1,30 @@
+/*
+ * Oled_trigtab.h - Q15 trigonometry tables
+ * Generated by tools/trigtab.py, do not edit.
+ */
+
+#ifndef OLED_TRIGTAB_H_
+#define OLED_TRIGTAB_H_
+
+// sin(0..90 degrees) in Q15
+static const int16_t g_pi16SinTable[91] = {
+		0, 572, 1144, 1715, 2286, 2856, 3425, 3993, 4560, 5126,
+		5690, 6252, 6813, 7371, 7927, 8481, 9032, 9580, 10126, 10668,
+		11207, 11743, 12275, 12803, 13328, 13848, 14365, 14876, 15384, 15886,
+		16384, 16877, 17364, 17847, 18324, 18795, 19261, 19720, 20174, 20622,
+		21063, 21498, 21926, 22348, 22763, 23170, 23571, 23965, 24351, 24730,
+		25102, 25466, 25822, 26170, 26510, 26842, 27166, 27482, 27789, 28088,
+		28378, 28660, 28932, 29197, 29452, 29698, 29935, 30163, 30382, 30592,
+		30792, 30983, 31164, 31336, 31499, 31651, 31795, 31928, 32052, 32166,
+		32270, 32365, 32449, 32524, 32588, 32643, 32688, 32723, 32748, 32763,
+		32767};
+
+// tan(d + 0.5 degree) in Q15: atan2 rounds to d + 1 from this bound
+static const uint16_t g_pui16AtanBound[45] = {
+		286, 858, 1431, 2004, 2579, 3155, 3733, 4314, 4897, 5483,
+		6073, 6667, 7264, 7867, 8474, 9087, 9706, 10332, 10964, 11604,
+		12251, 12908, 13573, 14248, 14933, 15630, 16338, 17058, 17792, 18539,
+		19302, 20080, 20876, 21689, 22521, 23373, 24247, 25144, 26065, 27012,
+		27987, 28991, 30026, 31096, 32201};
+
+#endif /* OLED_TRIGTAB_H_ */